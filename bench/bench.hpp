@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal benchmark harness shared by bench/bench_*.cpp.
+// Every result is one JSON object; a run prints a JSON array so results can
+// be diffed or plotted across releases.
+
+struct BenchResult {
+  std::string name;
+  std::map<std::string, std::string> params; // e.g. {"policy", "RR"}
+  uint64_t ops{0};
+  double seconds{0};
+
+  double ns_per_op() const { return ops ? seconds * 1e9 / ops : 0; }
+  double ops_per_sec() const { return seconds > 0 ? ops / seconds : 0; }
+};
+
+struct BenchOptions {
+  bool quick{false};        // smaller sizes, for CI and smoke runs
+  std::string out_path;     // JSON file (default: stdout)
+};
+
+inline BenchOptions parse_bench_args(int argc, char **argv) {
+  BenchOptions opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--quick") opts.quick = true;
+    else if (arg == "--out" && i + 1 < argc) opts.out_path = argv[++i];
+  }
+  return opts;
+}
+
+// Runs fn() once and times it; fn returns the number of operations it did
+template <typename Fn>
+BenchResult measure(const std::string &name, std::map<std::string, std::string> params, Fn &&fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  uint64_t ops = fn();
+  auto t1 = std::chrono::steady_clock::now();
+  BenchResult r{name, std::move(params), ops, std::chrono::duration<double>(t1 - t0).count()};
+  std::cerr << std::left << std::setw(28) << name;
+  for (const auto &[k, v] : r.params) std::cerr << " " << k << "=" << v;
+  std::cerr << "  " << std::fixed << std::setprecision(1) << r.ns_per_op() << " ns/op\n";
+  return r;
+}
+
+inline std::string to_json(const std::vector<BenchResult> &results) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(3) << "[\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto &r = results[i];
+    oss << "  {\"name\":\"" << r.name << "\",\"params\":{";
+    size_t j = 0;
+    for (const auto &[k, v] : r.params) oss << (j++ ? "," : "") << "\"" << k << "\":\"" << v << "\"";
+    oss << "},\"ops\":" << r.ops << ",\"seconds\":" << r.seconds
+        << ",\"ns_per_op\":" << r.ns_per_op() << ",\"ops_per_sec\":" << r.ops_per_sec() << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  oss << "]\n";
+  return oss.str();
+}
+
+inline void write_results(const std::vector<BenchResult> &results, const BenchOptions &opts) {
+  if (opts.out_path.empty()) {
+    std::cout << to_json(results);
+    return;
+  }
+  std::ofstream out(opts.out_path);
+  out << to_json(results);
+  std::cerr << "Results written to " << opts.out_path << "\n";
+}
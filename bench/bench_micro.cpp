@@ -0,0 +1,146 @@
+#include "bench.hpp"
+#include "../include/finished_map.hpp"
+#include "../include/process.hpp"
+#include "../include/process_generator.hpp"
+#include "../include/scheduler.hpp"
+#include "../include/util.hpp"
+#include <memory>
+#include <random>
+#include <thread>
+
+// Microbenchmarks for the emulator's hot paths. Usage:
+//   make bench                         # all sizes, JSON on stdout
+//   make bench BENCH_ARGS="--quick --out micro.json"
+
+// Channel::send/receive with several producers and consumers on one queue
+static BenchResult bench_channel(uint32_t producers, uint32_t consumers, uint64_t messages) {
+  return measure("channel_send_receive",
+                 {{"producers", std::to_string(producers)}, {"consumers", std::to_string(consumers)}},
+                 [&] {
+    Channel<uint64_t> ch;
+    std::vector<std::thread> threads;
+    uint64_t per_producer = messages / producers;
+    uint64_t per_consumer = per_producer * producers / consumers;
+    for (uint32_t i = 0; i < producers; ++i)
+      threads.emplace_back([&] { for (uint64_t m = 0; m < per_producer; ++m) ch.send(m); });
+    for (uint32_t i = 0; i < consumers; ++i)
+      threads.emplace_back([&] { for (uint64_t m = 0; m < per_consumer; ++m) ch.receive(); });
+    for (auto &t : threads) t.join();
+    return per_consumer * consumers;
+  });
+}
+
+// Ready queue insert and pop with randomised scheduling keys
+static void bench_ready_queue(SchedulingPolicy policy, uint32_t n, std::vector<BenchResult> &out) {
+  std::mt19937 rng(42);
+  std::vector<std::shared_ptr<Process>> procs;
+  procs.reserve(n);
+  for (uint32_t i = 0; i < n; ++i) {
+    auto p = std::make_shared<Process>(i, "p" + std::to_string(i), std::vector<Instruction>{});
+    p->priority = rng() % 40;
+    p->ready_tick = rng() % 100000;
+    p->vruntime = rng();
+    p->mlfq_level = rng() % 3;
+    p->deadline_tick = rng() % 2 ? rng() % 100000 : 0;
+    procs.push_back(p);
+  }
+
+  DynamicVictimChannel dvc(policy);
+  std::map<std::string, std::string> params{{"policy", policy_name(policy)}, {"size", std::to_string(n)}};
+  out.push_back(measure("ready_queue_insert", params, [&] {
+    for (auto &p : procs) dvc.send(p);
+    return static_cast<uint64_t>(n);
+  }));
+  out.push_back(measure("ready_queue_pop", params, [&] {
+    for (uint32_t i = 0; i < n; ++i) dvc.receiveNext();
+    return static_cast<uint64_t>(n);
+  }));
+}
+
+// Process::execute_tick calls on a program made of one instruction type.
+// FOR programs are unrolled at construction, so that cost is included for
+// FOR; SLEEP(1) takes two calls (the sleep and the wake-up tick).
+static BenchResult bench_execute(const std::string &type_name, Instruction ins, uint32_t n) {
+  bool is_for = ins.type == InstructionType::FOR;
+  return measure("process_execute_tick", {{"instruction", type_name}}, [&] {
+    std::vector<Instruction> program;
+    if (is_for) {
+      uint32_t body = static_cast<uint32_t>(ins.nested.size() * std::stoul(ins.args[0]));
+      program.assign(n / body, ins);
+    } else {
+      program.assign(n, ins);
+    }
+    auto p = std::make_shared<Process>(1, "bench", program);
+    uint32_t consumed = 0;
+    uint64_t calls = 0;
+    while (p->has_instructions_remaining()) {
+      p->execute_tick(0, 0, consumed);
+      ++calls;
+    }
+    return calls;
+  });
+}
+
+static void bench_finished_map(uint32_t n, std::vector<BenchResult> &out) {
+  std::vector<std::shared_ptr<Process>> procs;
+  procs.reserve(n);
+  for (uint32_t i = 0; i < n; ++i)
+    procs.push_back(std::make_shared<Process>(i, "p" + std::to_string(i), std::vector<Instruction>{}));
+
+  FinishedMap fm;
+  std::map<std::string, std::string> params{{"size", std::to_string(n)}};
+  out.push_back(measure("finished_map_insert", params, [&] {
+    for (uint32_t i = 0; i < n; ++i) fm.insert(procs[i], i);
+    return static_cast<uint64_t>(n);
+  }));
+  out.push_back(measure("finished_map_snapshot", params, [&] {
+    std::string snap = fm.snapshot();
+    return static_cast<uint64_t>(n);
+  }));
+}
+
+static BenchResult bench_generator(uint32_t processes) {
+  Config cfg;
+  cfg.num_cpu = 1;
+  Scheduler sched(cfg);
+  ProcessGenerator gen(cfg, sched);
+  return measure("generate_instructions", {{"top_level", "1000"}}, [&] {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < processes; ++i) {
+      uint32_t est = 0;
+      total += gen.generate_instructions(1000, est).size();
+    }
+    return total;
+  });
+}
+
+int main(int argc, char **argv) {
+  BenchOptions opts = parse_bench_args(argc, argv);
+  std::vector<BenchResult> results;
+
+  uint64_t messages = opts.quick ? 200000 : 2000000;
+  for (auto [p, c] : {std::pair{1u, 1u}, {4u, 1u}, {1u, 4u}, {4u, 4u}})
+    results.push_back(bench_channel(p, c, messages));
+
+  uint32_t queue_size = opts.quick ? 10000 : 200000;
+  for (auto policy : {RR, FCFS, PRIORITY, MLFQ, CFS, EDF})
+    bench_ready_queue(policy, queue_size, results);
+
+  uint32_t program = opts.quick ? 20000 : 500000;
+  Instruction nested{InstructionType::PRINT, {"Hello"}, {}};
+  results.push_back(bench_execute("PRINT", {InstructionType::PRINT, {"Hello"}, {}}, program));
+  results.push_back(bench_execute("DECLARE", {InstructionType::DECLARE, {"x", "5"}, {}}, program));
+  results.push_back(bench_execute("ADD", {InstructionType::ADD, {"x", "x", "1"}, {}}, program));
+  results.push_back(bench_execute("SUBTRACT", {InstructionType::SUBTRACT, {"x", "x", "1"}, {}}, program));
+  results.push_back(bench_execute("SLEEP", {InstructionType::SLEEP, {"1"}, {}}, program));
+  results.push_back(bench_execute("FOR", {InstructionType::FOR, {"10"}, {nested}}, program));
+
+  std::vector<uint32_t> finished_sizes = {10000, 100000};
+  if (!opts.quick) finished_sizes.push_back(1000000);
+  for (uint32_t n : finished_sizes) bench_finished_map(n, results);
+
+  results.push_back(bench_generator(opts.quick ? 50 : 1000));
+
+  write_results(results, opts);
+  return 0;
+}
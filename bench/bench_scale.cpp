@@ -0,0 +1,123 @@
+#include "bench.hpp"
+#include "../include/process.hpp"
+#include "../include/scheduler.hpp"
+#include <memory>
+#include <streambuf>
+#include <thread>
+
+// End-to-end scalability sweep: a real Scheduler with its CPUWorkers,
+// scheduler-tick-delay 0, over core counts x resident processes x policy.
+// One CSV row per point. Usage:
+//   make bench BENCH=scale                              # full sweep (big hosts)
+//   make bench BENCH=scale BENCH_ARGS="--quick --out scale.csv"
+//
+// Columns:
+//   ticks_per_sec          achieved tick rate
+//   sched_cpu_share        scheduler-thread CPU time / wall time (-1 if unknown)
+//   sched_barrier_share    scheduler thread blocked in tick barriers / wall time
+//   worker_barrier_share   mean over online workers of barrier wait / wall time
+//   p50/p99_latency_ticks  ready-to-running latency of dispatches in the window
+//
+// Built with LOCK_STATS=1, each point also prints its lock-site ranking for
+// the measured window to stderr.
+
+static constexpr uint32_t kProgramLength = 16;   // instructions per process
+
+struct ScalePoint {
+  SchedulingPolicy policy;
+  uint32_t num_cpu;
+  uint32_t processes;
+};
+
+// Discards the scheduler's console output so stdout stays valid CSV
+struct NullBuffer : std::streambuf {
+  int overflow(int c) override { return c; }
+};
+
+// DECLARE without arguments does nothing and allocates nothing, which keeps
+// a million resident processes within a few hundred MB
+static std::shared_ptr<Process> make_process(uint32_t id) {
+  static const std::vector<Instruction> program(kProgramLength, Instruction{InstructionType::DECLARE, {}, {}});
+  return std::make_shared<Process>(id, "s" + std::to_string(id), program);
+}
+
+static std::string run_point(const ScalePoint &pt, double warmup_s, double measure_s) {
+  Config cfg;
+  cfg.num_cpu = pt.num_cpu;
+  cfg.scheduler = pt.policy;
+  cfg.scheduler_tick_delay = 0;
+  cfg.delay_per_exec = 0;
+  cfg.snapshot_cooldown = UINT32_MAX;     // no screen-ls snapshots
+  Scheduler sched(cfg);
+
+  uint32_t next_id = 1;
+  for (; next_id <= pt.processes; ++next_id) sched.submit_process(make_process(next_id));
+  sched.start();
+
+  // Finished processes are replaced so the resident count stays constant
+  size_t replaced = 0;
+  auto feed_for = [&](double seconds) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < until) {
+      size_t finished = sched.finished_count();
+      for (; replaced < finished; ++replaced) sched.submit_process(make_process(next_id++));
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  };
+
+  feed_for(warmup_s);
+  reset_lock_stats();
+  TickStats before = sched.tick_stats();
+  LogLinearHistogram latency_before = sched.dispatch_latency();
+  feed_for(measure_s);
+  TickStats after = sched.tick_stats();
+  LogLinearHistogram latency = sched.dispatch_latency();
+  std::string locks = LOCK_STATS ? lock_stats_report() : "";
+  sched.stop();
+  latency.subtract(latency_before);
+
+  double wall = after.wall_seconds - before.wall_seconds;
+  double ticks = after.ticks - before.ticks;
+  double cpu = before.scheduler_cpu_seconds < 0 ? -1 : (after.scheduler_cpu_seconds - before.scheduler_cpu_seconds) / wall;
+  double sched_wait = (after.scheduler_barrier_seconds - before.scheduler_barrier_seconds) / wall;
+  double worker_wait = (after.worker_barrier_seconds - before.worker_barrier_seconds) / (wall * after.participants);
+
+  std::ostringstream row;
+  row << std::fixed << std::setprecision(3)
+      << policy_name(pt.policy) << "," << pt.num_cpu << "," << pt.processes << ","
+      << static_cast<uint64_t>(ticks) << "," << ticks / wall << "," << cpu << "," << sched_wait << ","
+      << worker_wait << "," << latency.percentile(0.50) << "," << latency.percentile(0.99) << "\n";
+  std::cerr << row.str() << locks;
+  return row.str();
+}
+
+int main(int argc, char **argv) {
+  BenchOptions opts = parse_bench_args(argc, argv);
+  std::vector<uint32_t> cores = opts.quick ? std::vector<uint32_t>{1, 4, 16}
+                                           : std::vector<uint32_t>{1, 2, 4, 8, 16, 32, 64, 128, 256};
+  std::vector<uint32_t> loads = opts.quick ? std::vector<uint32_t>{100, 10000}
+                                           : std::vector<uint32_t>{100, 1000, 10000, 100000, 1000000};
+  double warmup_s = opts.quick ? 0.1 : 0.5;
+  double measure_s = opts.quick ? 0.3 : 2.0;
+
+  const std::string header = "policy,num_cpu,processes,ticks,ticks_per_sec,sched_cpu_share,"
+                             "sched_barrier_share,worker_barrier_share,p50_latency_ticks,p99_latency_ticks\n";
+  std::string csv = header;
+  std::cerr << header;
+
+  NullBuffer null;
+  std::streambuf *console = std::cout.rdbuf(&null);
+  for (SchedulingPolicy policy : {FCFS, RR})
+    for (uint32_t n : cores)
+      for (uint32_t load : loads)
+        csv += run_point({policy, n, load}, warmup_s, measure_s);
+  std::cout.rdbuf(console);
+
+  if (opts.out_path.empty()) {
+    std::cout << csv;
+  } else {
+    std::ofstream(opts.out_path) << csv;
+    std::cerr << "Results written to " << opts.out_path << "\n";
+  }
+  return 0;
+}
@@ -5,27 +5,60 @@
 #include "reporter.hpp"
 #include "scheduler.hpp"
 #include "screen.hpp"
+#include "shadow.hpp"
+#include "workload_trace.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #ifndef MY_HEADER_FILE_H
 #define MY_HEADER_FILE_H
+
+// Command-line options for non-interactive runs (see main.cpp)
+struct BatchOptions {
+  std::string config_path{"config.txt"};
+  std::string script_path;      // CLI commands, one per line; '#' comments
+  uint32_t run_ticks{0};        // keep running this many ticks after the script
+  bool until_idle{false};       // stop the generator, wait for every process to finish
+  uint32_t timeout_s{0};        // give up waiting after this long (0 = never)
+  std::string summary_path;     // JSON summary file (default: stdout)
+};
+
 class CLI {
 public:
   CLI();
   ~CLI();
   int run(); // main loop; returns exit code
+  int run_batch(const BatchOptions &opts); // headless; returns exit code
+  void set_config_path(const std::string &path);
 private:
-  void handle_command(const std::string &cmd);
+  bool handle_command(const std::string &line); // false on exit
   Config cfg_;
+  std::mutex cfg_mtx_;                     // cfg_ is also written by the config watcher
+  std::string config_path_{"config.txt"};
   bool initialized_{false};
   Scheduler *scheduler_{nullptr};
   std::vector<std::unique_ptr<CPUWorker>> cpu_workers_;
   ScreenManager screen_mgr_;
   ProcessGenerator *generator_{nullptr};
+  WorkloadReplay *trace_replay_{nullptr}; // replaces the generator while set
+  ShadowScheduler *shadow_{nullptr};
   Reporter *reporter_{nullptr};
   private:
   bool require_init() const;
   void initialize_system();
   void handle_screen_command(const std::vector<std::string>& args);
+  void handle_hotplug_command(const std::vector<std::string>& args, bool online);
+  void start_trace_replay(const std::string& path);
+  void stop_trace_replay();
+  void handle_shadow_command(const std::vector<std::string>& args);
+  void stop_shadow();
+  void reload_config();
+  void start_config_watch();
+  void stop_config_watch();
+  std::thread watch_thread_;
+  std::atomic<bool> watching_{false};
   void attach_process_screen(const std::string& name, const std::shared_ptr<Process>& proc);
 };
 
@@ -1,16 +1,59 @@
 #pragma once
+#include "instruction.hpp"
 #include <cstdint>
 #include <string>
+#include <vector>
 
 enum SchedulingPolicy {
   RR,
   FCFS,
-  PRIORITY
+  PRIORITY,
+  MLFQ,
+  CFS,
+  EDF
+};
+
+// What admission does with a process whose deadline cannot be met
+enum class DeadlineAdmission {
+  NONE,   // admit everything
+  FLAG,   // admit but mark the process as infeasible
+  REJECT  // do not admit infeasible processes
+};
+
+// A named set of processes sharing a CPU budget (see `cgroup` in config.txt)
+struct GroupConfig {
+  std::string name;
+  uint32_t share = 1;     // relative weight when groups compete for cores
+  uint32_t quota_pct = 0; // hard cap: % of all core-ticks per period (0 = none)
+  bool operator==(const GroupConfig &) const = default;
+};
+
+// A named load shape for the generator (see `workload` in config.txt),
+// defined with profile.<name>.<field> keys. Zero sizes fall back to the
+// matching top-level keys.
+struct WorkloadProfile {
+  std::string name;
+  std::string arrival = "fixed";          // fixed | poisson | bursty
+  uint32_t interval = 0;                  // mean ticks between arrival events (0 = batch-process-freq)
+  uint32_t batch = 1;                     // processes per arrival event
+  uint32_t burst_size = 8;                // events per burst, one tick apart (bursty)
+  std::string ins_dist = "uniform";       // uniform | pareto
+  double pareto_alpha = 1.5;              // tail index; smaller = heavier tail
+  uint32_t min_ins = 0;                   // 0 = min-ins; pareto scale
+  uint32_t max_ins = 0;                   // 0 = max-ins; also caps pareto draws
+  std::vector<uint32_t> mix{1, 1, 1, 1, 1, 1}; // PRINT, DECLARE, ADD, SUBTRACT, SLEEP, FOR weights
+  uint32_t for_depth = FOR_MAX_NESTING;   // deepest FOR nesting generated
+  uint32_t for_min_repeats = 1;
+  uint32_t for_max_repeats = 3;
+  uint32_t for_min_body = 1;              // instructions per FOR body
+  uint32_t for_max_body = 3;
+  bool operator==(const WorkloadProfile &) const = default;
 };
 
 struct Config {
   uint32_t num_cpu = 4;
-  SchedulingPolicy scheduler = FCFS; // "rr" or "fcfs"
+  uint32_t max_cpu = 0;              // cores that can be onlined at runtime (0 = num_cpu)
+  SchedulingPolicy scheduler = FCFS; // "rr", "fcfs", "priority", "mlfq", "cfs" or "edf"
   uint32_t quantum_cycles = 5;
   uint32_t batch_process_freq = 1;
   uint32_t min_ins = 1000;
@@ -20,6 +63,107 @@ struct Config {
   // Maximum total instructions after FOR unrolling (0 = no limit)
   uint32_t max_unrolled_instructions = 10000;
   uint32_t snapshot_cooldown = 20;
+
+  // === Priority Scheduling ===
+  // Higher value = more important. Generated processes draw from
+  // [min_priority, max_priority], optionally weighted by priority_weights
+  // (one weight per level starting at min_priority).
+  uint32_t min_priority = 0;
+  uint32_t max_priority = 0;
+  std::vector<uint32_t> priority_weights;
+  bool priority_preempt = false; // preempt running process for a higher one
+  uint32_t aging_ticks = 0;      // ready ticks per +1 effective priority (0 = off)
+
+  // === Multi-Level Feedback Queue ===
+  // Level 0 is the highest. A process that uses up its level's quantum is
+  // demoted one level; every mlfq_boost_ticks all processes return to level 0.
+  uint32_t mlfq_levels = 3;
+  std::vector<uint32_t> mlfq_quanta; // per-level quanta; default quantum_cycles << level
+  uint32_t mlfq_boost_ticks = 200;   // 0 = never boost
+
+  // === Fair-Share (CFS-style) ===
+  // Processes accrue virtual runtime weighted by priority; the smallest
+  // vruntime runs next. A running process is only preempted after it has
+  // run at least cfs_min_granularity ticks.
+  uint32_t cfs_min_granularity = 4;
+
+  // === Earliest Deadline First ===
+  // Generated processes get a relative deadline in [min_deadline,
+  // max_deadline] ticks after arrival (max_deadline == 0: no deadline).
+  // Admission checks whether the remaining instructions still fit and
+  // applies deadline_admission to those that do not.
+  uint32_t min_deadline = 0;
+  uint32_t max_deadline = 0;
+  DeadlineAdmission deadline_admission = DeadlineAdmission::FLAG;
+
+  // === CPU Quota Groups ===
+  // One `cgroup <name>:<share>:<quota%>` line per group. Processes outside
+  // any configured group belong to an unlimited "default" group.
+  std::vector<GroupConfig> groups;
+  uint32_t group_period = 100;                // quota accounting period (ticks)
+  std::string generator_group = "batch";      // group for generated pNN jobs
+  std::string screen_group = "interactive";   // group for screen -s processes
+
+  // === Cache Affinity ===
+  // With affinity on, a preempted process waits up to affinity_window ticks
+  // for the core it last ran on before any other core may take it.
+  // A dispatch onto a core whose cache the process no longer owns stalls it
+  // for cache_cold_penalty ticks (0 = no penalty, counters only).
+  bool affinity = false;
+  uint32_t affinity_window = 5;
+  uint32_t cache_cold_penalty = 0;
+
+  // === Host Thread Pinning (Linux) ===
+  // pin-scheduler <host cpu>; pin-workers none | compact | scatter | <list>
+  int pin_scheduler = -1;                  // -1 = not pinned
+  std::string pin_workers = "none";        // "list" when pin_worker_cpus is given
+  std::vector<uint32_t> pin_worker_cpus;   // host cpu per emulated core
+
+  // === Live Reload ===
+  // reload-config applies "live" keys at the next tick boundary; the rest
+  // size or select structures built at initialize and need a restart.
+  bool watch_config = false;               // reload when config.txt changes
+
+  // === Deterministic Runs ===
+  // A non-zero seed fixes the generator's RNG, so two runs of the same
+  // config make the same decisions. record-trace writes every arrival and
+  // dispatch/preempt/finish decision for the replay command.
+  uint32_t seed = 0;                       // 0 = random
+  std::string record_trace;                // trace file ("" = not recording)
+
+  // === Execution Timeline ===
+  // Events kept per thread (scheduler and each core) for trace-dump; 0 = off
+  uint32_t timeline_events = 0;
+
+  // === Opcode Profile ===
+  // Per-core counts of executed instructions by type for vmstat; one
+  // instruction in opcode-sample is also timed (0 = count only)
+  bool opcode_profile = false;
+  uint32_t opcode_sample = 64;
+
+  // === Workload Profiles ===
+  std::string workload;                    // active profile ("" = uniform default)
+  std::vector<WorkloadProfile> profiles;
 };
 
+// Extra priority-weights beyond [min-priority, max-priority] are dropped
 Config load_config(const std::string &path);
+// "rr", "fcfs", "priority" (or "prio"), "mlfq", "cfs", "edf"; any case
+bool parse_policy(const std::string &name, SchedulingPolicy &out);
+std::string policy_name(SchedulingPolicy policy); // "RR", "FCFS", ...
+// "none", "flag", "reject"; any case
+bool parse_deadline_admission(const std::string &name, DeadlineAdmission &out);
+// Applies one config.txt line; false for an unknown key. Malformed numbers
+// and unknown deadline-admission values throw std::invalid_argument (or
+// std::out_of_range); load_config reports such lines and skips them.
+bool set_config_key(Config &cfg, std::string key, std::string value);
+
+// The selected profile with defaults filled in from cfg; the built-in
+// uniform profile if `workload` is empty or names no profile
+WorkloadProfile active_workload(const Config &cfg);
+
+// config.txt keys whose values differ between two configs
+std::vector<std::string> changed_keys(const Config &a, const Config &b);
+bool is_live_key(const std::string &key);
+// Copies every live key from src into dst
+void apply_live_keys(Config &dst, const Config &src);
@@ -16,6 +16,7 @@ public:
   void start();
   void stop();
   void join();
+  bool pin(int host_cpu); // after start(); false if not applied
 
 private:
   void loop();
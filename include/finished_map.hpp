@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include "process.hpp"
+#include "lock_stats.hpp"
 
 using ProcessPtr = std::shared_ptr<Process>;
 using OrderedEntry = std::pair<uint32_t, ProcessPtr>;
@@ -27,5 +28,5 @@ class FinishedMap {
     std::multimap<uint32_t, std::weak_ptr<Process>, std::greater<>> finished_by_tick_;
     std::multimap<time_t, std::weak_ptr<Process>, std::greater<>> finished_by_time_;
     std::unordered_map<std::string, uint32_t> duplicate_count_;
-    std::mutex mutex_;
+    TrackedMutex mutex_{"finished_map"};
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Fixed-size histogram with log-linear buckets: values below 16 are exact,
+// above that every power of two is split into 16 linear sub-buckets, so any
+// percentile is within 1/16 (6.25%) of the true value. Recording is O(1) and
+// allocation-free. Not thread-safe; callers serialize access.
+class LogLinearHistogram {
+  public:
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;
+    static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    void record(uint64_t value, uint64_t count = 1);
+    void merge(const LogLinearHistogram &other);
+    void subtract(const LogLinearHistogram &earlier); // counts since `earlier`
+    void clear();
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+    // Smallest bucket upper bound covering q (0..1) of the samples
+    uint64_t percentile(double q) const;
+    std::string summary() const; // "n=.. mean=.. p50=.. p90=.. p99=.. max=.."
+
+  private:
+    friend class AtomicLogLinearHistogram;
+    static size_t bucket_of(uint64_t value);
+    static uint64_t bucket_upper(size_t bucket);
+
+    std::array<uint64_t, kBuckets> counts_{};
+    uint64_t count_{0};
+    uint64_t sum_{0};
+    uint64_t max_{0};
+};
+
+// Adds `by` to a counter that only one thread ever writes. A plain load and
+// store is enough and avoids a locked read-modify-write; with two writers,
+// increments would be lost. Readers may load it at any time.
+inline void relaxed_add(std::atomic<uint64_t> &counter, uint64_t by) {
+  counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+// Same buckets, for one writer thread and any number of readers: recording
+// bumps relaxed atomics, and snapshot() copies them out without a lock. A
+// snapshot that races a record may be missing that one sample's sum or max.
+class AtomicLogLinearHistogram {
+  public:
+    void record(uint64_t value);              // writer only
+    void clear();                             // writer only
+    LogLinearHistogram snapshot() const;
+
+  private:
+    std::array<std::atomic<uint64_t>, LogLinearHistogram::kBuckets> counts_{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
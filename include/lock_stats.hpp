@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Lock contention accounting for the hot mutexes (build with
+// `make LOCK_STATS=1`). Each mutex names a lock site; every mutex with the
+// same name (e.g. all Process::m_mutex) adds to the same counters.
+// Without LOCK_STATS, TrackedMutex is a plain std::mutex.
+#ifndef LOCK_STATS
+#define LOCK_STATS 0
+#endif
+
+struct LockSite {
+  const char *name{nullptr};
+  alignas(64) std::atomic<uint64_t> acquisitions{0};
+  std::atomic<uint64_t> contended{0};    // lock() had to block
+  std::atomic<uint64_t> wait_ns{0};
+  std::atomic<uint64_t> max_wait_ns{0};
+  std::atomic<uint64_t> hold_ns{0};
+  std::atomic<uint64_t> max_hold_ns{0};
+};
+
+// The site registered under `name`, created on first use; never freed
+LockSite *lock_site(const char *name);
+
+// std::mutex that times blocked acquisitions and hold time. Uncontended
+// locks cost a try_lock and two clock reads.
+class ProfiledMutex {
+public:
+  explicit ProfiledMutex(const char *site) : site_(lock_site(site)) {}
+  ProfiledMutex(const ProfiledMutex &) = delete;
+  ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+private:
+  std::mutex m_;
+  LockSite *site_;
+  std::chrono::steady_clock::time_point acquired_at_{}; // guarded by m_
+};
+
+#if LOCK_STATS
+using TrackedMutex = ProfiledMutex;
+using TrackedCondition = std::condition_variable_any;
+using TrackedLock = std::unique_lock<ProfiledMutex>;
+#else
+class TrackedMutex : public std::mutex {
+public:
+  explicit TrackedMutex(const char *) {}
+};
+using TrackedCondition = std::condition_variable;
+using TrackedLock = std::unique_lock<std::mutex>;
+#endif
+
+struct LockSiteStats {
+  std::string name;
+  uint64_t acquisitions{0};
+  uint64_t contended{0};
+  uint64_t wait_ns{0};
+  uint64_t max_wait_ns{0};
+  uint64_t hold_ns{0};
+  uint64_t max_hold_ns{0};
+};
+
+// Every site with at least one acquisition, most total wait first
+std::vector<LockSiteStats> lock_stats();
+void reset_lock_stats();
+std::string lock_stats_report();
@@ -1,5 +1,8 @@
 #pragma once
 #include "instruction.hpp"
+#include "lock_stats.hpp"
+#include <atomic>
+#include <cstdint>
 #include <ctime>
 #include <mutex>
 #include <string>
@@ -26,12 +29,28 @@ struct ProcessReturnContext{
 
 bool is_yielded(ProcessReturnContext context) noexcept;
 
+/**
+ * Per-core instruction counters (opcode-profile in config.txt), indexed by
+ * InstructionType. Only the owning core's worker writes them; one
+ * instruction in `sample_period` is also timed.
+ */
+struct alignas(64) OpcodeProfile {
+  static constexpr size_t kOpcodes = static_cast<size_t>(InstructionType::FOR) + 1;
+  std::atomic<uint64_t> executed[kOpcodes]{};
+  std::atomic<uint64_t> sampled[kOpcodes]{};
+  std::atomic<uint64_t> sampled_ns[kOpcodes]{};
+  uint32_t sample_period{0};  // 0 = count only
+  uint32_t until_sample{0};   // worker only
+};
+
 /**
  * Runtime metrics for process execution
  * Extended to include instruction counts, timing, and CPU affinity.
  */
 struct ProcessMetrics {
-  uint32_t created_tick{0};
+  uint32_t created_tick{0};                 // admitted by the scheduler
+  uint32_t first_run_tick{UINT32_MAX};      // first dispatch (UINT32_MAX = never ran)
+  uint32_t preemptions{0};                  // running -> ready transitions
   uint32_t finished_tick{0};
   uint32_t executed_instructions{0};
   uint32_t total_instructions{0};
@@ -59,10 +78,19 @@ public:
   std::string summary_line(bool colorize = false) const; // for screen -ls
 
   // === Scheduler metadata ===
-  uint32_t priority{0};         // process priority
-  uint32_t ticks_waited{0};     // for aging or fairness
+  uint32_t priority{0};         // process priority (higher runs first)
+  uint32_t ticks_waited{0};     // total ticks spent in the ready queue
+  uint32_t ready_tick{0};       // tick it last entered the ready queue (aging)
   uint32_t last_active_tick{0}; // for LRU / victim selection
-  uint32_t cpu_id{256};         // which CPU last ran it
+  uint32_t cpu_id{UINT32_MAX};  // which CPU last ran it (UINT32_MAX = never dispatched)
+  uint32_t mlfq_level{0};       // MLFQ queue level (0 = highest)
+  uint32_t mlfq_epoch{0};       // boost epoch the level belongs to
+  uint64_t vruntime{0};         // CFS weighted virtual runtime
+  uint32_t deadline{0};         // relative deadline in ticks (0 = none)
+  uint32_t deadline_tick{0};    // absolute deadline, stamped on submit
+  bool deadline_flagged{false}; // admitted although the deadline looked infeasible
+  uint32_t group_id{0};         // CPU quota group (0 = default, unlimited)
+  uint32_t migrations{0};       // dispatches onto a different core than last time
 
   // === Program Related Members ===
   uint32_t pc{0};                                 // program counter
@@ -79,10 +107,13 @@ public:
   uint32_t get_total_instructions() const;
   uint32_t get_executed_instructions() const;
   uint32_t get_remaining_sleep_ticks() const;
+  const std::vector<Instruction> &instructions() const; // unrolled program
+  uint32_t get_source_instructions() const;            // before FOR unrolling, FOR headers included
 
   // === Sleep Helpers ===
   void set_sleep_ticks(uint32_t ticks);
   void clear_sleep();
+  void add_stall_ticks(uint32_t ticks); // busy-wait before the next instruction
 
   // === State Query Helpers ===
   bool is_new() const noexcept;
@@ -100,12 +131,19 @@ public:
   void mark_swapped();
   void mark_finished(uint32_t tick);
 
+  // === Latency Stamps (scheduler thread) ===
+  void stamp_arrival(uint32_t tick);
+  bool stamp_dispatch(uint32_t tick);   // true on the first dispatch
+  void stamp_preemption();
+  ProcessMetrics get_metrics() const;
+
   bool has_instructions_remaining() const noexcept;
 
   // Execution API used by CPUWorker
-  // Returns the state of the process after this tick's execution
+  // Returns the state of the process after this tick's execution. With a
+  // profile, the executed instruction is counted there.
   ProcessReturnContext execute_tick(uint32_t global_tick, uint32_t delays_per_exec,
-                            uint32_t &consumed_ticks);
+                            uint32_t &consumed_ticks, OpcodeProfile *profile = nullptr);
 
 private:
   uint32_t m_id;
@@ -113,11 +151,12 @@ private:
   std::vector<Instruction> m_instr;
   ProcessState m_state{ProcessState::NEW};
   std::vector<std::string> m_logs;
-  mutable std::mutex m_mutex; // protects state, logs, vars, pc
+  mutable TrackedMutex m_mutex{"process"}; // protects state, logs, vars, pc
 
   // runtime helpers
   uint32_t m_delay_remaining{0};
   uint32_t m_sleep_remaining{0};
   uint32_t m_for_stack_depth{0};
+  uint32_t m_source_instructions{0};
   ProcessMetrics m_metrics;
 };
@@ -2,16 +2,25 @@
 #include "config.hpp"
 #include "instruction.hpp"
 #include "scheduler.hpp"
+#include "workload_trace.hpp"
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
 #include <thread>
 #include <vector>
 
-// May also be better as a Singleton as only one generator is needed
+// Arrivals are driven by the scheduler clock through its tick hook; a
+// background thread pre-generates programs into a small pool so a tick only
+// pays for handing a batch over.
 class ProcessGenerator {
 public:
   ProcessGenerator(const Config &cfg, Scheduler &sched);
   void start();
   void stop();
+  // Live keys of `next` apply from the next generated process on
+  void reload_config(const Config &next);
 
   // Generate up to target_top_level top-level instructions while respecting
   // the configured max_unrolled_instructions budget. Returns the generated
@@ -19,11 +28,45 @@ public:
   std::vector<Instruction> generate_instructions(uint32_t target_top_level,
                                                  uint32_t &estimated_size);
 
+  // The next `count` arrivals as records, ticks relative to the first, for
+  // replaying one seeded workload on several schedulers (see sweep.hpp).
+  // Only while stopped.
+  std::vector<WorkloadRecord> sample_workload(uint32_t count);
+
+  // Processes a tick had to generate itself because the pool ran dry
+  uint64_t pool_misses() const { return pool_misses_.load(); }
+
 private:
-  void loop();
+  void loop();                          // pool producer
+  void on_tick(uint32_t tick);          // scheduler thread
+  uint32_t arrive(const Config &cfg);   // one arrival event; returns the next gap
+  std::vector<std::shared_ptr<Process>> take(size_t n, const Config &cfg,
+                                             const WorkloadProfile &profile);
+  std::shared_ptr<Process> make_process(const Config &cfg,
+                                        const WorkloadProfile &profile); // rng_mtx_ held
+  std::vector<Instruction> generate(uint32_t target_top_level, uint32_t budget,
+                                    const WorkloadProfile &profile,
+                                    uint32_t &estimated_size); // rng_mtx_ held
+  Config config();
+  std::mutex cfg_mtx_; // guards cfg_ against reload_config
   Config cfg_;
   Scheduler &sched_;
   std::thread thread_;
   std::atomic<bool> running_{false};
+
+  // Programs come from rng_ in id order whichever thread makes them: the
+  // producer holds rng_mtx_ until its process is in the pool. Arrival gaps
+  // have their own stream so pool timing cannot shift them.
+  std::mutex rng_mtx_;  // also taken by the CLI thread (screen -s)
+  std::mt19937 rng_;
+  std::mt19937 arrival_rng_;   // scheduler thread
+  uint32_t burst_left_{0};     // scheduler thread
+  uint32_t ticks_to_next_{0};  // scheduler thread
   std::atomic<uint32_t> next_id_{1};
+
+  // === Pre-generated Pool ===
+  std::mutex pool_mtx_;
+  std::condition_variable pool_cv_;
+  std::deque<std::shared_ptr<Process>> pool_;
+  std::atomic<uint64_t> pool_misses_{0};
 };
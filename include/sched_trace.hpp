@@ -0,0 +1,81 @@
+#pragma once
+#include "config.hpp"
+#include "instruction.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Process;
+
+// Scheduling decisions written by record-trace and checked by replay. A
+// trace is a small header followed by one variable-length record per event;
+// ARRIVAL records carry the whole (unrolled) program so a replay needs
+// nothing but the trace file.
+enum class TraceKind : uint8_t { ARRIVAL, DISPATCH, PREEMPT, FINISH };
+
+struct TraceEvent {
+  TraceKind kind{TraceKind::ARRIVAL};
+  uint32_t tick{0};
+  uint32_t pid{0};
+  uint32_t cpu{0};        // 0 for ARRIVAL
+  bool operator==(const TraceEvent &) const = default;
+};
+
+// Everything needed to rebuild an arriving process
+struct TraceArrival {
+  uint32_t pid{0};
+  std::string name;
+  uint32_t priority{0};
+  uint32_t deadline{0};
+  uint32_t deadline_tick{0};
+  uint32_t group_id{0};
+  std::vector<Instruction> program;
+};
+
+// Keys the run was recorded with; replay applies them over the current config
+struct TraceHeader {
+  uint32_t num_cpu{0};
+  SchedulingPolicy scheduler{FCFS};
+  uint32_t quantum_cycles{0};
+  uint32_t delay_per_exec{0};
+  uint32_t seed{0};
+};
+
+struct SchedTrace {
+  TraceHeader header;
+  std::vector<TraceEvent> events;
+  std::vector<TraceArrival> arrivals; // one per ARRIVAL event, same order
+};
+
+// Appends events from the scheduler thread; buffered, flushed on close
+class SchedTraceWriter {
+public:
+  bool open(const std::string &path, const Config &cfg);
+  void record(TraceKind kind, uint32_t tick, const Process &p, uint32_t cpu);
+  void close();
+  uint64_t events() const { return events_; }
+
+private:
+  std::ofstream out_;
+  uint32_t last_tick_{0};  // ticks are stored as deltas
+  uint64_t events_{0};
+};
+
+bool read_sched_trace(const std::string &path, SchedTrace &out, std::string &error);
+std::string describe(const TraceEvent &e);
+
+struct ReplayResult {
+  bool ok{false};           // every recorded event was reproduced
+  std::string error;        // trace could not be read
+  std::string divergence;   // first mismatch
+  uint64_t events{0};
+  uint64_t matched{0};
+  uint32_t ticks{0};
+  double wall_ms{0};
+};
+
+// Re-runs a recorded trace on a fresh scheduler (the header's keys over
+// `base`, no tick delay) and stops at the first decision that differs
+ReplayResult replay_sched_trace(const std::string &path, const Config &base);
+std::string replay_report(const ReplayResult &r);
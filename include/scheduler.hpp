@@ -3,7 +3,9 @@
 #include "process.hpp"
 #include "finished_map.hpp"
 #include "cpu_worker.hpp"
+#include "thread_pinning.hpp"
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <memory>
@@ -12,15 +14,21 @@
 #include <unordered_map>
 #include <vector>
 #include "util.hpp"
-#include <barrier>
+#include "tick_barrier.hpp"
+#include "histogram.hpp"
+#include "sched_trace.hpp"
+#include "timeline.hpp"
 #include <queue>
 #include <functional>
+#include <optional>
 
-// Note: May be better to implement as a Singleton as we only want one Scheduler
-// Check out `docs/scheduler.md` for design notes.
+// Instances share no state, so several can run side by side in one process
+// (see sweep.hpp). Check out `docs/scheduler.md` for design notes.
 
 using ProcessPtr = std::shared_ptr<Process>;
 using ProcessCmpFn = std::function<bool(const ProcessPtr&, const ProcessPtr&)>;
+using TickHook = std::function<void(uint32_t tick)>;
+using TraceHook = std::function<void(TraceKind kind, uint32_t tick, const Process &p, uint32_t cpu)>;
 
 
 struct ProcessComparator {
@@ -29,6 +37,204 @@ struct ProcessComparator {
 };
 
 
+// Outcome counters for deadline-tagged processes. Lateness is
+// finish_tick - deadline_tick (negative = finished early).
+struct DeadlineSummary {
+  static constexpr size_t kBuckets = 6;
+  static const char *const kBucketLabels[kBuckets];
+  uint64_t met{0};
+  uint64_t missed{0};
+  uint64_t flagged{0};   // admitted although infeasible ("flag" admission)
+  uint64_t rejected{0};  // refused at admission ("reject" admission)
+  int64_t total_lateness{0};
+  int64_t max_lateness{0};
+  uint64_t lateness[kBuckets]{};
+};
+
+
+// Runtime state of a CPU quota group. Everything except `ready` is guarded
+// by Scheduler::short_term_mtx_.
+struct CpuGroup {
+  std::string name;
+  uint32_t share{1};
+  uint32_t quota_pct{0};
+  uint32_t quota_ticks{0};            // core-ticks allowed per period (0 = unlimited)
+  uint32_t core_cap{0};               // cores allowed while other groups wait (0 = no cap)
+  uint32_t used_in_period{0};
+  uint32_t running{0};
+  std::atomic<uint32_t> ready{0};     // processes of this group in the ready queue
+  uint64_t used_total{0};
+  uint64_t throttled_ticks{0};        // ticks spent over quota with work pending
+  std::deque<std::shared_ptr<Process>> parked; // held back by quota or share
+};
+
+// Copy of a group's counters for reporting
+struct GroupUsage {
+  std::string name;
+  uint32_t share;
+  uint32_t quota_pct;
+  uint64_t used_total;
+  uint64_t throttled_ticks;
+  uint32_t running;
+  uint32_t ready;
+  uint32_t parked;
+};
+
+// Cache-affinity counters. Only re-dispatches are classified: a process's
+// first dispatch is cold on every core.
+struct AffinityStats {
+  uint64_t warm{0};                   // same core, nobody ran there in between
+  uint64_t cold{0};
+  uint64_t stall_ticks{0};            // cache_cold_penalty ticks charged
+  uint64_t stall_ticks_saved{0};      // penalty avoided by warm dispatches
+  uint64_t migrations{0};
+  std::vector<uint64_t> migrations_per_cpu; // migrations into each core
+};
+
+// A yield/finish/sleep reported by a worker, applied by the scheduler thread
+// at the start of the next tick
+struct CoreEvent {
+  ProcessReturnContext context;
+  uint32_t tick{0};
+};
+
+// Per-core handoff between the scheduler thread and one CPUWorker. The
+// scheduler publishes the core's process before the first tick barrier; the
+// worker reads it after that barrier and posts events back without locking.
+struct alignas(64) CoreMailbox {
+  std::atomic<Process *> assigned{nullptr};
+  SpscQueue<CoreEvent, 4> events;     // worker -> scheduler, at most one per tick
+  std::atomic<uint64_t> barrier_wait_ns{0}; // written by the worker only
+  std::atomic<int64_t> waiting_since_ns{0}; // worker only: steady_clock start of the current wait, 0 if none
+  // Tick profile, worker only: the three barrier rounds of a tick are
+  // counted apart, and each tick's total wait goes into the histogram of
+  // the current profile generation
+  std::atomic<uint64_t> round_wait_ns[3]{};
+  uint32_t barrier_round{0};
+  uint64_t tick_wait_ns{0};
+  uint32_t profile_generation{0};
+  AtomicLogLinearHistogram tick_wait[2];
+  std::atomic<uint64_t> busy_ticks{0};      // worker only: ticks it executed a process
+  std::atomic<uint64_t> idle_ticks{0};      // worker only: ticks it had nothing to run
+};
+
+// Arrivals and finishes for an observer on another thread (see shadow.hpp).
+// The scheduler thread is the only producer; a full feed drops the event.
+struct FeedEvent {
+  enum Kind : uint8_t { ARRIVAL, FINISH };
+  Kind kind{ARRIVAL};
+  uint32_t tick{0};
+  uint32_t pid{0};
+  uint32_t instructions{0};   // ARRIVAL: unrolled program length
+  uint32_t priority{0};       // ARRIVAL
+  uint32_t waited{0};         // FINISH: ticks spent in the ready queue
+};
+
+struct EventFeed {
+  SpscQueue<FeedEvent, 16384> events;
+  std::atomic<uint64_t> dropped{0};
+};
+
+// Cumulative tick-loop cost since start(); callers diff two samples
+struct TickStats {
+  uint32_t ticks{0};
+  double wall_seconds{0};
+  double scheduler_cpu_seconds{0};    // CPU time of the scheduler thread (-1 if unknown)
+  double scheduler_barrier_seconds{0}; // scheduler thread blocked in tick barriers
+  double worker_barrier_seconds{0};   // summed over online cores
+  // Barrier waits include the part of any wait still in progress, so the
+  // difference of two snapshots covers exactly the time between them
+  uint32_t participants{0};           // online cores
+  uint64_t busy_core_ticks{0};        // core-ticks that executed a process
+  uint64_t idle_core_ticks{0};        // online core-ticks with nothing to run
+};
+
+// Latency distributions of a set of processes, in ticks. The scheduler
+// records them as processes are first dispatched and finish; any thread
+// may read them.
+struct LatencyHistograms {
+  AtomicLogLinearHistogram response;     // arrival to first dispatch
+  AtomicLogLinearHistogram waiting;      // total time in the ready queue
+  AtomicLogLinearHistogram turnaround;   // arrival to finish
+  AtomicLogLinearHistogram preemptions;  // running -> ready, per finished process
+};
+
+struct LatencySnapshot {
+  std::string label;                     // policy name, or "group <name>"
+  LogLinearHistogram response;
+  LogLinearHistogram waiting;
+  LogLinearHistogram turnaround;
+  LogLinearHistogram preemptions;
+};
+
+// Where tick time goes (see sched-prof). Totals are since start(); the
+// histograms (nanoseconds) cover the last kProfileGenerationMs to twice that.
+struct PhaseCost {
+  TimelinePhase phase{TimelinePhase::IDLE};
+  uint64_t total_ns{0};
+  LogLinearHistogram recent;          // one sample per tick
+};
+
+struct WorkerWait {
+  uint32_t cpu{0};
+  bool online{false};
+  uint64_t round_ns[3]{};             // waiting for dispatch, execution, tick advance
+  LogLinearHistogram recent;          // total wait per tick
+};
+
+struct TickProfile {
+  uint32_t ticks{0};
+  double wall_seconds{0};
+  std::vector<PhaseCost> phases;      // every TimelinePhase, in order
+  std::vector<WorkerWait> workers;    // every core slot that ever ran
+};
+
+// Instructions executed by type (see vmstat). Counts are exact; mean_ns
+// comes from the sampled instructions only.
+struct OpcodeCost {
+  InstructionType type{InstructionType::PRINT};
+  uint64_t executed{0};
+  uint64_t sampled{0};
+  uint64_t sampled_ns{0};
+};
+
+struct OpcodeStats {
+  bool enabled{false};
+  uint32_t sample_period{0};
+  std::vector<OpcodeCost> opcodes;    // every InstructionType, in order
+  std::vector<uint64_t> per_core;     // executed instructions per core slot
+  uint64_t programs{0};               // processes admitted
+  uint64_t source_instructions{0};    // as written, FOR headers included
+  uint64_t unrolled_instructions{0};  // after FOR unrolling
+};
+
+// Busy share of online core-ticks over a trailing wall-clock window
+struct UtilizationWindow {
+  uint32_t seconds{0};
+  double covered_seconds{0};          // shorter than `seconds` while the series is young
+  uint64_t busy_ticks{0};
+  uint64_t idle_ticks{0};
+  double fraction() const {
+    uint64_t total = busy_ticks + idle_ticks;
+    return total ? static_cast<double>(busy_ticks) / total : 0.0;
+  }
+};
+
+struct CoreUtilization {
+  bool online{false};
+  bool busy{false};                   // has a process this tick
+  uint64_t busy_ticks{0};             // since the scheduler was created
+  uint64_t idle_ticks{0};
+};
+
+struct UtilizationReport {
+  std::vector<CoreUtilization> cores; // every core slot
+  uint32_t online{0};
+  uint32_t busy_now{0};
+  std::vector<UtilizationWindow> windows; // 1s, 10s, 60s
+};
+
+
 class Scheduler {
 public:
   Scheduler() = default;
@@ -49,6 +255,11 @@ public:
   // === Short-Term Scheduling API ===
   std::shared_ptr<Process> dispatch_to_cpu(uint32_t cpu_id);
   void release_cpu_interrupt(uint32_t cpu_id, std::shared_ptr<Process> p, ProcessReturnContext context);
+
+  // === CPU Worker API (lock-free) ===
+  Process *assigned_process(uint32_t cpu_id) const;           // after the first tick barrier
+  void post_core_event(uint32_t cpu_id, ProcessReturnContext context);
+  void account_core_tick(uint32_t cpu_id, bool busy);         // once per tick, after executing
   
   // === Pre-Post Scheduling API ===
   void sleep_process(std::shared_ptr<Process> p, uint64_t duration);
@@ -57,24 +268,79 @@ public:
   // === Diagnostics ===
   std::string snapshot(); // returns screen-ls string
   uint32_t current_tick() const;
+  bool is_idle();                 // nothing queued, sleeping, parked or running
+  size_t finished_count();
 
-  // === Singleton Accessor ===
-  Scheduler(Scheduler &other) = delete;       // Should not be copied
+  Scheduler(const Scheduler &) = delete;      // Should not be copied
   void operator=(const Scheduler &) = delete; // Should not be assigned
-  Scheduler& getInstance();
-  void initialize(const Config &cfg);
 
   void pause();
   void resume();
   bool is_paused() const;
-  void tick_barrier_sync();
+  void tick_barrier_sync();                 // scheduler thread
+  void tick_barrier_sync(uint32_t cpu_id);  // CPU worker; times its wait
   void stop_barrier_sync();
 
   uint32_t get_cpu_count() const;
   uint32_t get_scheduler_tick_delay() const;
-  std::string get_sched_snapshots();
+  uint32_t get_delay_per_exec() const;
+  std::string get_sched_snapshots();                // newest kKeptSnapshots, then cleared
   void setSchedulingPolicy(SchedulingPolicy policy_);
   std::string get_sleep_queue_snapshot();
+  std::vector<uint32_t> mlfq_queue_lengths() const; // ready processes per MLFQ level
+  DeadlineSummary deadline_summary();
+  std::string deadline_report();                    // empty if no deadlines seen
+  uint32_t group_id(const std::string &name) const;  // 0 (default) if unknown
+  std::vector<GroupUsage> group_usage();
+  std::string group_report();                       // empty if no groups configured
+  AffinityStats affinity_stats();
+  std::string affinity_report();                    // empty unless affinity is modelled
+  PinLayout pinning() const;                        // host CPUs actually applied (-1 = unpinned)
+  uint32_t get_cpu_capacity() const;                // core slots, online or not
+  bool is_cpu_online(uint32_t cpu_id) const;
+  // Hotplug requests are validated now and applied at the next tick boundary;
+  // false if the core does not exist, is already in that state, or is the
+  // last online core
+  bool request_cpu_online(uint32_t cpu_id);
+  bool request_cpu_offline(uint32_t cpu_id);
+  // Live keys of `next` (see is_live_key) take effect at the next tick
+  // boundary; other differences are ignored until the next initialize
+  void reload_config(const Config &next);
+  // quantum-cycles only sets RR slices and MLFQ quanta not given explicitly
+  bool uses_quantum_cycles() const;
+  std::string pinning_report() const;               // empty if no pinning configured
+  LogLinearHistogram dispatch_latency();            // ticks from READY to RUNNING
+  TickStats tick_stats() const;
+  // Per-core counters plus the 1s/10s/60s windows; O(cores), no tick lock
+  UtilizationReport utilization();
+  // Under the policy as a whole, then per CPU group if groups are configured
+  std::vector<LatencySnapshot> latency() const;
+  std::string latency_report() const;               // empty until a process arrives
+  // Per-phase scheduler time and per-worker barrier waits; lock-free
+  TickProfile tick_profile() const;
+  std::string tick_profile_report() const;
+  // Per-opcode counts summed over the cores; lock-free
+  OpcodeStats opcode_stats() const;
+  std::string opcode_stats_report() const;
+  // Counters for the worker of `cpu_id`; nullptr unless opcode-profile is set
+  OpcodeProfile *opcode_profile(uint32_t cpu_id) const {
+    return opcode_profile_ ? &opcode_profile_[cpu_id] : nullptr;
+  }
+
+  // === Hooks (run on the scheduler thread, inside the tick) ===
+  // The tick hook runs every tick just before admission, so processes it
+  // submits are admitted in the same tick. The trace hook sees every
+  // arrival, dispatch, preemption and finish. Pass nullptr to remove.
+  void set_tick_hook(TickHook hook);
+  void set_trace_hook(TraceHook hook);
+  bool record_trace(const std::string &path);       // false if the file cannot be written
+  void set_event_feed(std::shared_ptr<EventFeed> feed); // nullptr to detach
+  // Per-thread execution timeline; nullptr unless timeline-events is set.
+  // Workers record their yields into it directly.
+  Timeline *timeline() const { return timeline_.get(); }
+  // Ids for processes that trace-replay submits; never reused by this
+  // scheduler, however many replays run
+  uint32_t next_replay_pid() { return replay_pid_.fetch_add(1); }
 
 
 private:
@@ -87,17 +353,74 @@ private:
   void timer_check();
   void log_status();
   void pause_check();
+  void drain_core_events();       // apply worker events from the previous tick
+  void apply_hotplug();           // pending cpu-online / cpu-offline requests
+  void apply_pending_config();    // pending reload_config()
+  void cpu_online(uint32_t cpu_id);
+  void cpu_offline(uint32_t cpu_id);
+  void publish_assignments();     // running_ -> per-core mailboxes
+  void sample_utilization();      // append to util_ring_ every kUtilizationSampleMs
+  void release_cpu(uint32_t cpu_id, std::shared_ptr<Process> p,
+                   const ProcessReturnContext &context, uint32_t tick);
+  void priority_preemption();     // PRIORITY: displace lowest running process
+  void mlfq_preemption();         // MLFQ: demote on quantum expiry, favour higher levels
+  void mlfq_boost();              // MLFQ: move every process back to level 0
+  void cfs_preemption();          // CFS: charge vruntime, switch to smaller vruntime
+  void edf_preemption();          // EDF: earlier deadline displaces later one
+  bool admit_deadline(const std::shared_ptr<Process> &p); // false = rejected
+  void record_deadline_outcome(const std::shared_ptr<Process> &p, uint32_t finish_tick);
+  void initialize_groups();
+  void initialize_latency();
+  void initialize_profile();
+  void latency_arrival(Process &p);                     // scheduler thread
+  void latency_dispatch(Process &p, uint32_t now);      // short_term_mtx_ held
+  void latency_preemption(Process &p);                  // short_term_mtx_ held
+  void latency_finish(Process &p, uint32_t finish_tick); // short_term_mtx_ held
+  void rescale_groups();          // quotas and core caps follow the online core count
+  void group_accounting();        // charge running groups, throttle, roll periods
+  bool group_admit(const std::shared_ptr<Process> &p);  // short_term_mtx_ held
+  void group_released(const std::shared_ptr<Process> &p); // short_term_mtx_ held
+  bool group_fill_idle();         // unpark share-capped work onto idle cores
+  bool group_can_run(const CpuGroup &g) const;          // short_term_mtx_ held
+  bool affinity_eligible(const Process &p, uint32_t cpu_id, uint32_t now) const; // short_term_mtx_ held
+  void affinity_account(Process &p, uint32_t cpu_id);   // short_term_mtx_ held
+  void enqueue_ready(std::shared_ptr<Process> p);
+  void trace(TraceKind kind, const Process &p, uint32_t cpu = 0) {
+    if (trace_hook_) trace_hook_(kind, this->tick_.load(), p, cpu);
+  }
+  void feed(FeedEvent::Kind kind, const Process &p) {
+    if (!event_feed_) return;
+    FeedEvent e{kind, this->tick_.load(), p.id(), p.get_total_instructions(), p.priority, p.ticks_waited};
+    if (!event_feed_->events.tryPush(e)) event_feed_->dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  // Timeline events from the scheduler thread; one branch when disabled.
+  // Phase changes also feed the always-on tick profile.
+  void mark(TimelineKind kind, const Process &p, uint32_t cpu = 0) {
+    if (timeline_) timeline_->scheduler(kind, this->tick_.load(), p.id(), cpu);
+  }
+  void mark_phase(TimelinePhase phase) {
+    profile_phase(phase);
+    if (timeline_) timeline_->phase(phase, this->tick_.load());
+  }
+  void profile_phase(TimelinePhase phase);                 // scheduler thread
+  void profile_barrier_wait(uint32_t cpu_id, uint64_t ns); // worker cpu_id
+  void initialize_opcode_profile();
+  void opcode_arrival(const Process &p);                   // scheduler thread
+  uint32_t quantum_for(const Process &p) const;
+  void fill_mlfq_quanta();                                 // missing levels from quantum_cycles
 
   // === Internal Scheduler State === 
   Config cfg_;
   std::thread sched_thread_;
   std::atomic<uint32_t> tick_{0};
   std::atomic<bool> paused_{false};
-  std::condition_variable pause_cv_;
+  TrackedCondition pause_cv_;
   std::atomic<bool> sched_running_{false};
-  std::mutex short_term_mtx_;
-  std::mutex scheduler_mtx_;
-  std::unique_ptr<std::barrier<>> tick_sync_barrier_;
+  TrackedMutex short_term_mtx_{"scheduler.short_term"};
+  TrackedMutex scheduler_mtx_{"scheduler.tick"};
+  std::unique_ptr<TickBarrier> tick_sync_barrier_;
+  // Nothing drains this during a run, so only the newest snapshots are kept
+  static constexpr size_t kKeptSnapshots = 8;
   Channel<std::string> log_queue;
   std::string cpu_state_snapshot();
   
@@ -109,13 +432,108 @@ private:
   std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<>> sleep_queue_;  // sleep process, timer
 
   // === CPU State ===
+  uint32_t cpu_capacity_{0};                            // max(num_cpu, max_cpu) core slots
+  std::unique_ptr<std::atomic<bool>[]> online_;         // indexed by cpu id
+  std::atomic<uint32_t> online_cpus_{0};
+  std::mutex hotplug_mtx_;
+  std::vector<std::pair<uint32_t, bool>> hotplug_requests_; // (cpu, online), applied per tick
+  std::vector<bool> hotplug_target_;                    // online state once requests apply
+
+  // === Live Reload ===
+  // Also held while live keys are applied, so reports on other threads can
+  // copy the ones they print (affinity, MLFQ quanta)
+  std::mutex reload_mtx_;
+  std::optional<Config> pending_cfg_;                   // applied at the next tick boundary
   std::vector<std::shared_ptr<CPUWorker>> cpu_workers_; // cpu threads, indexed by cpu id
   std::vector<std::shared_ptr<Process>> running_;       // running processes, indexed by cpu id
   FinishedMap finished_;      // finished processes, indexed by cpu id
   
+  PinLayout pinned_;                                    // applied in start()
+  void apply_pinning();
+  PinLayout pinning_plan() const;
+
   // === Scheduler Metrics ===
-  std::vector<uint64_t> busy_ticks_per_cpu_;            // Busy ticks
   std::vector<uint32_t> cpu_quantum_remaining_;         // RR bookkeeping
+  std::unique_ptr<CoreMailbox[]> mailboxes_;            // indexed by cpu id
+
+  // === MLFQ State ===
+  uint32_t mlfq_epoch_{0};                                   // bumped on every boost
+  bool mlfq_quanta_derived_{false};                          // mlfq-quanta unset: follow quantum_cycles
+  std::unique_ptr<std::atomic<uint32_t>[]> mlfq_level_len_;  // ready processes per level
+
+  // === CFS State ===
+  std::atomic<uint64_t> min_vruntime_{0};                    // monotonic floor for placement
+
+  // === Deadline State ===
+  std::mutex deadline_mtx_;
+  DeadlineSummary deadline_stats_;
+  std::vector<std::shared_ptr<Process>> rejected_;           // refused by admission control
+
+  // === CPU Quota Groups ===
+  std::vector<CpuGroup> groups_;                             // [0] is the default group
+  bool groups_enabled_{false};
+
+  // === Cache Affinity ===
+  std::vector<uint32_t> last_pid_on_cpu_;                    // cache owner per core
+  std::vector<uint64_t> migrations_per_cpu_;
+  uint64_t warm_dispatches_{0};
+  uint64_t cold_dispatches_{0};
+  uint64_t cold_stall_ticks_{0};
+
+  // === Tick Cost ===
+  LogLinearHistogram dispatch_latency_;                      // short_term_mtx_
+  std::chrono::steady_clock::time_point started_at_{};
+  std::atomic<uint64_t> sched_barrier_wait_ns_{0};
+  std::atomic<int64_t> sched_waiting_since_ns_{0};           // see CoreMailbox::waiting_since_ns
+
+  // === Latency ===
+  std::unique_ptr<LatencyHistograms[]> latency_;             // [0] every process, [1 + g] group g
+
+  // === Tick Profile ===
+  // Histograms alternate between two generations: the scheduler thread
+  // starts a new one every kProfileGenerationMs and workers follow at their
+  // next tick, each clearing its own half before reuse
+  struct PhaseProfile {
+    std::atomic<uint64_t> total_ns{0};
+    AtomicLogLinearHistogram recent[2];
+  };
+  static constexpr uint32_t kProfileGenerationMs = 5000;
+  std::unique_ptr<PhaseProfile[]> phase_profile_;            // [TimelinePhase]
+  std::atomic<uint32_t> profile_generation_{0};
+  TimelinePhase current_phase_{TimelinePhase::IDLE};         // scheduler thread
+  std::chrono::steady_clock::time_point phase_started_at_{}; // scheduler thread
+  std::chrono::steady_clock::time_point generation_started_at_{}; // scheduler thread
+
+  // === Opcode Profile ===
+  std::unique_ptr<OpcodeProfile[]> opcode_profile_;          // [cpu], fixed at construction
+  std::atomic<uint64_t> admitted_programs_{0};               // scheduler thread writes
+  std::atomic<uint64_t> admitted_source_{0};
+  std::atomic<uint64_t> admitted_unrolled_{0};
+
+  // === Utilization Series ===
+  // Summed core counters sampled by the scheduler thread; a window is the
+  // difference between the live counters and the sample that old
+  struct UtilizationSample {
+    std::chrono::steady_clock::time_point at{};
+    uint64_t busy{0};
+    uint64_t idle{0};
+  };
+  static constexpr uint32_t kUtilizationSampleMs = 100;
+  static constexpr size_t kUtilizationSlots = 640;           // a little over 60 s
+  std::mutex util_mtx_;
+  std::vector<UtilizationSample> util_ring_;                 // util_mtx_
+  size_t util_next_{0};                                      // util_mtx_, slot to write
+  size_t util_count_{0};                                     // util_mtx_
+  std::chrono::steady_clock::time_point util_last_{};        // scheduler thread
+
+  // === Hooks === (scheduler_mtx_)
+  TickHook tick_hook_;
+  TraceHook trace_hook_;
+  std::unique_ptr<SchedTraceWriter> recorder_;
+  std::shared_ptr<EventFeed> event_feed_;
+  std::unique_ptr<Timeline> timeline_;                       // fixed at construction
+  static constexpr uint32_t kFirstReplayPid = 1000000;       // above generator and screen -s ids
+  std::atomic<uint32_t> replay_pid_{kFirstReplayPid};
 
   // === Scheduler State ===
 
@@ -0,0 +1,106 @@
+#pragma once
+#include "config.hpp"
+#include "histogram.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Scheduler;
+struct EventFeed;
+
+// What-if model of another policy over the live workload. Jobs only need
+// their service time (program length x (1 + delay-per-exec)); time jumps
+// from one arrival, completion or quantum expiry to the next, so nothing is
+// executed. SLEEP counts as a tick of CPU, and there is no affinity, groups
+// or admission control. FCFS, RR and PRIORITY (preemptive, FCFS among
+// equals) are modelled; other policies fall back to FCFS.
+class ShadowModel {
+public:
+  ShadowModel(SchedulingPolicy policy, uint32_t cores, uint32_t quantum);
+
+  // Arrivals come in tick order; the model first catches up to `tick`
+  void arrive(uint64_t tick, uint32_t pid, uint64_t service, uint32_t priority);
+  void advance_to(uint64_t tick);
+
+  uint64_t now() const { return now_; }
+  size_t in_flight() const { return jobs_.size(); }
+  const LogLinearHistogram &waiting() const { return waiting_; }       // turnaround - service
+  const LogLinearHistogram &turnaround() const { return turnaround_; }
+
+private:
+  struct Job {
+    uint64_t arrival{0};
+    uint64_t service{0};
+    uint64_t remaining{0};
+    uint32_t priority{0};
+    uint64_t seq{0};          // arrival order, FCFS tie-break
+  };
+  struct Core {
+    uint32_t pid{0};
+    bool busy{false};
+    uint64_t quantum_left{0};
+  };
+  // Ready order: (priority rank, seq); FCFS/RR use rank 0
+  using ReadyKey = std::pair<uint64_t, uint64_t>;
+
+  ReadyKey key_of(const Job &j) const;
+  void make_ready(uint32_t pid);
+  void dispatch();
+
+  SchedulingPolicy policy_;
+  uint32_t quantum_;
+  uint64_t now_{0};
+  uint64_t next_seq_{0};
+  std::vector<Core> cores_;
+  std::unordered_map<uint32_t, Job> jobs_;
+  std::set<std::pair<ReadyKey, uint32_t>> ready_;
+  LogLinearHistogram waiting_;
+  LogLinearHistogram turnaround_;
+};
+
+// Runs a ShadowModel beside a live scheduler, fed by its event feed, and
+// compares waiting and turnaround time with what the live policy achieved,
+// keeping one line per snapshot_cooldown ticks for the trend. The live tick
+// only pushes two fixed-size events per process.
+class ShadowScheduler {
+public:
+  ShadowScheduler(Scheduler &sched, const Config &live, SchedulingPolicy policy, uint32_t quantum);
+  ~ShadowScheduler();
+
+  void start();
+  void stop();
+  std::string report();        // comparison so far plus the recent periods
+  std::string describe() const; // "RR q=4 on 4 cores"
+
+private:
+  void loop();
+  void poll();                 // drain the feed and advance the model
+  std::string build_report();  // model_mtx_ held
+  std::string period_line(uint64_t tick); // model_mtx_ held
+
+  Scheduler &sched_;
+  std::shared_ptr<EventFeed> feed_;
+  SchedulingPolicy policy_;
+  uint32_t quantum_;
+  uint32_t cores_;
+  SchedulingPolicy live_policy_;
+  uint32_t delay_per_exec_;
+  uint32_t cooldown_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+
+  std::mutex model_mtx_;
+  ShadowModel model_;
+  std::unordered_map<uint32_t, uint32_t> live_arrival_; // pid -> tick
+  LogLinearHistogram live_waiting_;
+  LogLinearHistogram live_turnaround_;
+  uint64_t last_period_{0};
+  std::deque<std::string> periods_;  // newest last
+};
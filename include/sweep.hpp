@@ -0,0 +1,52 @@
+#pragma once
+#include "config.hpp"
+#include "workload_trace.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Parameter sweep: one workload run through every combination of a grid of
+// config.txt values, on independent Scheduler instances in parallel. Each
+// instance runs without tick delay, so a point costs only its CPU time.
+
+// One grid axis: a config.txt key and the values to try
+struct SweepAxis {
+  std::string key;
+  std::vector<std::string> values;
+};
+
+// "key=v1,v2,..."; false with a message for an unknown key or bad value
+bool parse_sweep_axis(const std::string &spec, SweepAxis &out, std::string &error);
+
+struct SweepOptions {
+  Config base;                   // every point starts from this
+  std::vector<SweepAxis> grid;
+  uint32_t processes{200};       // arrivals drawn from the seeded generator
+  std::string workload_trace;    // or: every arrival of this workload trace
+  uint32_t jobs{0};              // instances at once (0 = hardware threads)
+  uint32_t max_ticks{1000000};   // a point still busy after this is cut short
+};
+
+struct SweepPoint {
+  std::vector<std::string> values;  // one per axis
+  bool completed{false};            // every process finished within max_ticks
+  uint32_t ticks{0};                // first arrival to last process done
+  uint64_t finished{0};
+  double throughput{0};             // finished per 1000 ticks
+  double mean_turnaround{0};        // arrival to finish, ticks
+  uint64_t p99_turnaround{0};
+  double mean_waiting{0};           // time in the ready queue, ticks
+  uint64_t p99_waiting{0};
+  double utilization{0};            // busy core-ticks / (cores * ticks)
+  double wall_ms{0};
+};
+
+// The workload the sweep will run, drawn once from opts
+bool sweep_workload(const SweepOptions &opts, std::vector<WorkloadRecord> &out, std::string &error);
+// Runs one configuration to completion on its own scheduler
+SweepPoint run_sweep_point(const Config &cfg, const std::vector<WorkloadRecord> &workload, uint32_t max_ticks);
+// Every grid point, in grid order (the last axis varies fastest)
+bool run_sweep(const SweepOptions &opts, std::vector<SweepPoint> &out, std::string &error);
+
+std::string sweep_table(const SweepOptions &opts, const std::vector<SweepPoint> &points);
+std::string sweep_csv(const SweepOptions &opts, const std::vector<SweepPoint> &points);
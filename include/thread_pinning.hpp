@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "config.hpp"
+
+// Host CPU assignment for the scheduler thread and the CPUWorker threads.
+// A value of -1 means "not pinned".
+struct PinLayout {
+  int scheduler_cpu{-1};
+  std::vector<int> worker_cpus;      // indexed by emulated core id
+  std::vector<int> host_cpus;        // CPUs this process may run on
+};
+
+// Host CPUs in this process's affinity mask (all online CPUs if unknown)
+std::vector<int> host_cpus();
+
+// Resolves pin-scheduler / pin-workers against the available host CPUs.
+// compact: consecutive host CPUs; scatter: evenly strided across them.
+// The scheduler's CPU is skipped for workers while enough CPUs remain.
+PinLayout plan_pinning(const Config &cfg, const std::vector<int> &host);
+
+// Pins a running thread; false if pinning is unsupported or was refused
+bool pin_thread(std::thread &t, int host_cpu);
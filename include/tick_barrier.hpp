@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Reusable barrier whose participant count can change between phases,
+// unlike std::barrier. Arrivals and the phase generation share one 64-bit
+// word (generation << 32 | arrived); the last arrival starts the next
+// generation and wakes the waiters.
+//
+// add() must be called by a participant that has not yet arrived in the
+// current phase (the scheduler thread does it before its first barrier), so
+// the phase cannot complete underneath it. A participant leaves with
+// arrive_and_drop(), which counts as its arrival in the current phase.
+class TickBarrier {
+  public:
+    explicit TickBarrier(uint32_t participants);
+
+    void arrive_and_wait();
+    void arrive_and_drop();            // arrive without waiting, then leave
+    void add(uint32_t participants);   // join from the current phase on
+    uint32_t participants() const;
+
+  private:
+    void arrive(bool wait);
+
+    std::atomic<uint64_t> state_{0};
+    std::atomic<uint32_t> expected_;
+    std::atomic<uint32_t> pending_drops_{0}; // applied when the phase completes
+};
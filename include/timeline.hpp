@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Execution timeline for Chrome's trace viewer / Perfetto (`timeline-events`
+// in config.txt). The scheduler thread and every CPUWorker append fixed-size
+// events to a ring of their own, which keeps only the newest events;
+// trace-dump converts all rings to trace-event JSON. Nothing is allocated
+// or locked while recording.
+enum class TimelineKind : uint8_t {
+  DISPATCH, PREEMPT, SLEEP, FINISH,   // scheduler thread, per core
+  WAKE,                               // scheduler thread, sleep queue -> ready
+  YIELD,                              // worker: process handed back sleep/finish
+  PHASE                               // scheduler thread: tick_loop phase starts
+};
+
+// tick_loop phases in order. A phase ends where the next one begins; IDLE
+// covers the tick delay and pauses. The scheduler's tick profiler uses the
+// same boundaries.
+enum class TimelinePhase : uint8_t {
+  HOUSEKEEPING, TIMERS, PREEMPTION, ADMISSION, DISPATCH, EXECUTE, LOG, ADVANCE, IDLE
+};
+constexpr size_t kTimelinePhases = static_cast<size_t>(TimelinePhase::IDLE) + 1;
+const char *timeline_phase_name(TimelinePhase phase);
+
+struct TimelineEvent {
+  uint64_t ns{0};          // since the timeline was created
+  uint32_t tick{0};
+  uint32_t pid{0};         // TimelinePhase for PHASE
+  uint16_t cpu{0};
+  TimelineKind kind{TimelineKind::PHASE};
+};
+
+// Single-writer ring that overwrites its oldest events. Any thread may
+// snapshot it while the writer runs; events the writer may have been
+// overwriting during the copy are dropped.
+class TimelineRing {
+public:
+  explicit TimelineRing(size_t events);      // keeps at least `events`
+  void push(const TimelineEvent &e);         // writer only
+  std::vector<TimelineEvent> snapshot() const; // oldest first
+  uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> ns{0};
+    std::atomic<uint64_t> tick_pid{0};
+    std::atomic<uint32_t> cpu_kind{0};
+  };
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_{0};
+  alignas(64) std::atomic<uint64_t> written_{0};
+};
+
+class Timeline {
+public:
+  Timeline(uint32_t cores, size_t events_per_thread);
+
+  // Scheduler thread only
+  void scheduler(TimelineKind kind, uint32_t tick, uint32_t pid, uint32_t cpu) {
+    rings_[cores_]->push({now_ns(), tick, pid, static_cast<uint16_t>(cpu), kind});
+  }
+  void phase(TimelinePhase phase, uint32_t tick) {
+    rings_[cores_]->push({now_ns(), tick, static_cast<uint32_t>(phase), 0, TimelineKind::PHASE});
+  }
+  // Worker for `cpu` only
+  void core(uint32_t cpu, TimelineKind kind, uint32_t tick, uint32_t pid) {
+    rings_[cpu]->push({now_ns(), tick, pid, static_cast<uint16_t>(cpu), kind});
+  }
+
+  uint32_t cores() const { return cores_; }
+  uint64_t recorded() const;                  // ever written, kept or not
+  // Every ring merged by time
+  std::vector<TimelineEvent> events() const;
+
+private:
+  uint64_t now_ns() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origin_).count());
+  }
+  uint32_t cores_;
+  std::chrono::steady_clock::time_point origin_;
+  std::vector<std::unique_ptr<TimelineRing>> rings_; // [cpu], then the scheduler
+};
+
+// Chrome trace-event JSON: one track per core with a slice per dispatch
+// (ended by its preemption, sleep or finish), yield and wake instants, and
+// a scheduler track with one slice per tick_loop phase. Returns the number
+// of trace events written, or -1 if the file cannot be written.
+int64_t write_chrome_trace(const Timeline &timeline, const std::string &path);
+std::string chrome_trace_json(const Timeline &timeline, uint64_t *trace_events = nullptr);
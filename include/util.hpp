@@ -8,9 +8,12 @@
 #include <memory>
 #include <functional>
 #include <condition_variable>
+#include <atomic>
+#include <array>
 #include "config.hpp"
 #include "process.hpp"
 #include "util.hpp"
+#include "lock_stats.hpp"
 
 uint16_t clamp_uint16(int64_t v);
 std::string now_iso();
@@ -25,25 +28,27 @@ using ProcessCmpFn = std::function<bool(const ProcessPtr&, const ProcessPtr&)>;
 template<typename T>
 class Channel {
   public:
+    explicit Channel(const char *lock_site = "channel") : messageMtx_(lock_site) {}
     void send(const T& message);
     
     T receive();
 
     bool isEmpty();
     std::string snapshot();
-    void empty();
+    void clear();
+    void trim(size_t keep);     // drop the oldest messages beyond the newest `keep`
 
   private:
     std::deque<T> q_;
-    std::mutex messageMtx_;
-    std::condition_variable messageCv_;
+    TrackedMutex messageMtx_;
+    TrackedCondition messageCv_;
 };
 
 
 template<typename T>
 void Channel<T>::send(const T& message) {
   {
-    std::lock_guard<std::mutex> lock(messageMtx_);
+    std::lock_guard<TrackedMutex> lock(messageMtx_);
     this->q_.emplace_back(message);
   }
   messageCv_.notify_one();
@@ -51,7 +56,7 @@ void Channel<T>::send(const T& message) {
 
 template<typename T>
 T Channel<T>::receive() {
-  std::unique_lock<std::mutex> lock(messageMtx_);
+  TrackedLock lock(messageMtx_);
   messageCv_.wait(lock, [this]() { return !q_.empty(); });
   T message = q_.front();
   q_.pop_front();
@@ -60,20 +65,26 @@ T Channel<T>::receive() {
 
 template<typename T>
 bool Channel<T>::isEmpty() {
-  std::lock_guard<std::mutex> lock(messageMtx_);
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
   return q_.empty();
 }
 
 template<typename T>
-void Channel<T>::empty(){
-  std::lock_guard<std::mutex> lock(messageMtx_);
-  q_.empty();
+void Channel<T>::clear(){
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
+  q_.clear();
+}
+
+template<typename T>
+void Channel<T>::trim(size_t keep){
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
+  while (q_.size() > keep) q_.pop_front();
 }
 
 
 template<>
 inline std::string Channel<std::string>::snapshot(){
-  std::lock_guard<std::mutex> lock(messageMtx_);
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
   std::ostringstream oss;
   for (const auto &msg : this->q_){
     oss << msg;
@@ -83,7 +94,7 @@ inline std::string Channel<std::string>::snapshot(){
 
 template<>
 inline std::string Channel<std::shared_ptr<Process>>::snapshot() {
-  std::lock_guard<std::mutex> lock(messageMtx_);
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
   std::ostringstream oss;
   oss << "Channel Snapshot: " << q_.size() << " messages\n";
   for (const auto &msg : q_) {
@@ -101,6 +112,40 @@ inline std::string Channel<std::shared_ptr<Process>>::snapshot() {
   return oss.str();
 }
 
+// Bounded single-producer/single-consumer ring. No locks: the producer owns
+// tail_, the consumer owns head_, and each publishes with a release store.
+// N must be a power of two.
+template<typename T, size_t N>
+class SpscQueue {
+  static_assert((N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+  public:
+    bool tryPush(T message);   // producer only; false when full
+    bool tryPop(T &message);   // consumer only; false when empty
+
+  private:
+    std::array<T, N> slots_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+template<typename T, size_t N>
+bool SpscQueue<T, N>::tryPush(T message) {
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == N) return false;
+  slots_[tail & (N - 1)] = std::move(message);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template<typename T, size_t N>
+bool SpscQueue<T, N>::tryPop(T &message) {
+  size_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) return false;
+  message = std::move(slots_[head & (N - 1)]);
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
 template<typename T>
 class BufferedChannel {
   public:
@@ -136,16 +181,23 @@ struct ProcessComparer {
 
 class DynamicVictimChannel {
   public:
-    DynamicVictimChannel(SchedulingPolicy algo);
+    DynamicVictimChannel(SchedulingPolicy algo, uint32_t aging_ticks = 0);
 
     // Algorithm Setting Methods
     void setPolicy(SchedulingPolicy algo);
+    void setAging(uint32_t aging_ticks);
     void reformatQueue();
+    void rekey(const std::function<void(Process &)> &fn); // mutate keys, then re-sort
 
     // Message Passing Methods
     void send(const std::shared_ptr<Process>& msg);
     std::shared_ptr<Process> receiveNext();
     std::shared_ptr<Process> receiveVictim();
+    std::shared_ptr<Process> peekNext();
+    // Non-blocking: remove the first of the next `limit` processes that
+    // satisfies `pred`, or return nullptr if none of them does
+    std::shared_ptr<Process> receiveFirst(const std::function<bool(const Process &)> &pred,
+                                          size_t limit);
 
     // Accessor
     bool isEmpty();
@@ -156,11 +208,21 @@ class DynamicVictimChannel {
   
   private:
     SchedulingPolicy policy_;
+    uint32_t aging_ticks_{0};
     ProcessCmpFn comparator_;
-    std::mutex messageMtx_;
-    std::condition_variable messageCv_;
+    TrackedMutex messageMtx_{"ready_queue"};
+    TrackedCondition messageCv_;
 };
 
+// Priority of a ready process after aging: +1 for every `aging_ticks` spent
+// in the ready queue since `ready_tick`. Aging is off when aging_ticks == 0.
+uint32_t effective_priority(const Process &p, uint32_t now, uint32_t aging_ticks);
+
+// CFS load weight for a priority (priority p behaves like nice -p; 0 -> 1024)
+uint32_t cfs_weight(uint32_t priority);
+// Virtual runtime charged for one tick of execution at the given priority
+uint64_t cfs_vruntime_delta(uint32_t priority);
+
 // An Entry of a Process for the Timer to check
 struct TimerEntry {
   std::shared_ptr<Process> process;
@@ -0,0 +1,133 @@
+#pragma once
+#include "config.hpp"
+#include "instruction.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Process;
+class Scheduler;
+
+// Captured arrival patterns replayed as load (trace-replay), in place of the
+// ProcessGenerator. A workload trace is a text file, one record per line:
+//
+//   # comment
+//   program <ref> <program>                 reusable program image
+//   <tick> <name> <priority> <program>      arrival, tick relative to the start
+//   <tick> <name> <priority> @<ref>         arrival running a program image
+//
+// Ticks never decrease. A program is instructions separated by ';', each
+// OP or OP(arg, ...), with FOR(n){...} for loops, e.g.
+//   DECLARE(x, 5); FOR(3){ADD(x, x, 1); PRINT("x is up")}; SLEEP(2)
+// Unlike a scheduling trace (record-trace / replay) this carries only the
+// load, so it can be replayed under any policy or core count.
+
+// Parses a program; false with a message on the first syntax error
+bool parse_program(const std::string &text, std::vector<Instruction> &out, std::string &error);
+// Inverse of parse_program, for writing traces
+std::string format_program(const std::vector<Instruction> &ins);
+
+// One arrival, with its program resolved
+struct WorkloadRecord {
+  uint32_t tick{0};
+  std::string name;
+  uint32_t priority{0};
+  uint32_t deadline{0};          // relative, ticks (not in the text format)
+  std::shared_ptr<const std::vector<Instruction>> program;
+};
+
+// Streams a workload trace line by line; memory use is the program images
+// plus one line, whatever the file size
+class WorkloadTraceReader {
+public:
+  bool open(const std::string &path, std::string &error);
+  // Next arrival; false at the end of the file. Malformed lines are
+  // skipped and counted.
+  bool next(WorkloadRecord &out);
+
+  uint64_t bytes_read() const { return bytes_read_; }
+  uint64_t file_size() const { return file_size_; }
+  uint64_t bad_lines() const { return bad_lines_; }
+  const std::string &first_error() const { return first_error_; }
+
+private:
+  void reject(const std::string &why);
+
+  std::ifstream in_;
+  std::unordered_map<std::string, std::shared_ptr<const std::vector<Instruction>>> images_;
+  uint64_t line_no_{0};
+  uint64_t bytes_read_{0};
+  uint64_t file_size_{0};
+  uint32_t last_tick_{0};
+  uint64_t bad_lines_{0};
+  std::string first_error_;
+};
+
+struct WorkloadReplayStatus {
+  std::string path;
+  bool running{false};
+  bool done{false};            // every arrival submitted
+  uint64_t submitted{0};
+  uint32_t trace_tick{0};      // ticks since the replay started
+  uint32_t last_arrival_tick{0};
+  uint64_t bytes_read{0};
+  uint64_t file_size{0};
+  uint64_t bad_lines{0};
+  uint64_t stalls{0};          // ticks that waited for the reader
+  std::string first_error;
+};
+
+// Feeds a workload trace into a scheduler on its clock. A reader thread
+// parses ahead into a bounded queue; the scheduler's tick hook submits the
+// records that are due, so arrivals land on exactly their trace tick.
+class WorkloadReplay {
+public:
+  WorkloadReplay(Scheduler &sched, const Config &cfg);
+  ~WorkloadReplay();
+
+  // Once per object; takes over the scheduler's tick hook until stop()
+  bool start(const std::string &path, std::string &error);
+  void stop();
+  bool done() const { return done_.load(); }
+  WorkloadReplayStatus status() const;
+
+private:
+  void read_loop();
+  void on_tick(uint32_t tick);
+
+  Scheduler &sched_;
+  uint32_t group_id_{0};
+  std::string path_;
+  WorkloadTraceReader reader_;   // reader thread
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> done_{false};
+
+  // === Read-ahead Queue ===
+  mutable std::mutex queue_mtx_;
+  std::condition_variable queue_cv_;
+  std::deque<WorkloadRecord> queue_;
+  bool eof_{false};              // queue_mtx_
+  uint64_t bytes_read_{0};       // queue_mtx_, copied from the reader
+  uint64_t bad_lines_{0};        // queue_mtx_
+  std::string first_error_;      // queue_mtx_
+
+  // Scheduler thread
+  bool started_{false};
+  uint32_t first_tick_{0};
+  std::atomic<uint64_t> submitted_{0};
+  std::atomic<uint32_t> trace_tick_{0};
+  std::atomic<uint32_t> last_arrival_tick_{0};
+  std::atomic<uint64_t> stalls_{0};
+  uint64_t file_size_{0};
+};
+
+std::string workload_replay_report(const WorkloadReplayStatus &s);
@@ -5,6 +5,10 @@
 #include <vector>
 #include <cctype>
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 
 // util funcs
 
@@ -44,6 +48,9 @@ static void prompt() { std::cout << "csopesy> " << std::flush; }
 CLI::CLI() = default;
 
 CLI::~CLI() {
+  stop_config_watch();
+  stop_trace_replay();
+  stop_shadow();
   if (generator_) generator_->stop();
   if (scheduler_) { scheduler_->stop(); delete scheduler_; scheduler_ = nullptr; }
   if (reporter_) { delete reporter_; reporter_ = nullptr; }
@@ -60,11 +67,26 @@ bool CLI::require_init() const {
 }
 
 void CLI::initialize_system() {
-  cfg_ = load_config("config.txt");
+  stop_config_watch();
+  {
+    std::lock_guard<std::mutex> lock(cfg_mtx_);
+    cfg_ = load_config(config_path_);
+  }
+  if (!cfg_.workload.empty() && active_workload(cfg_).name != cfg_.workload)
+    std::cout << "Unknown workload profile " << cfg_.workload << "; using the uniform default.\n";
 
+  stop_trace_replay();
+  stop_shadow();
   if (scheduler_) { scheduler_->stop(); delete scheduler_; }
   scheduler_ = new Scheduler(cfg_);
+  if (!cfg_.record_trace.empty()) {
+    if (scheduler_->record_trace(cfg_.record_trace))
+      std::cout << "Recording scheduling trace to " << cfg_.record_trace << "\n";
+    else
+      std::cout << "Cannot write trace file " << cfg_.record_trace << "\n";
+  }
   scheduler_->start();
+  std::cout << scheduler_->pinning_report();
 
   if (generator_) delete generator_;
   generator_ = new ProcessGenerator(cfg_, *scheduler_);
@@ -74,6 +96,69 @@ void CLI::initialize_system() {
 
   initialized_ = true;
   std::cout << "Initialization complete.\n";
+
+  if (cfg_.watch_config) start_config_watch();
+}
+
+// Re-reads the config file and hands it to the scheduler and generator, which
+// take the live keys at their next tick / next process. Keys that size or
+// select structures built at initialize are only reported.
+void CLI::reload_config() {
+  if (!require_init()) return;
+
+  Config next = load_config(config_path_);
+  std::vector<std::string> applied, restart, unused;
+  {
+    std::lock_guard<std::mutex> lock(cfg_mtx_);
+    for (const auto &key : changed_keys(cfg_, next)) {
+      if (key == "quantum-cycles" && !scheduler_->uses_quantum_cycles())
+        unused.push_back(key); // stored, but the running policy never reads it
+      else
+        (is_live_key(key) ? applied : restart).push_back(key);
+    }
+    if (applied.empty() && restart.empty() && unused.empty()) {
+      std::cout << "Config unchanged.\n";
+      return;
+    }
+    apply_live_keys(cfg_, next);
+  }
+  scheduler_->reload_config(next);
+  generator_->reload_config(next);
+
+  auto join = [](const std::vector<std::string> &keys) {
+    std::string out;
+    for (const auto &k : keys) out += (out.empty() ? "" : ", ") + k;
+    return out.empty() ? std::string("(none)") : out;
+  };
+  std::cout << "Applied at next tick: " << join(applied) << "\n";
+  if (!unused.empty())
+    std::cout << "Not used by " << policy_name(cfg_.scheduler) << ": " << join(unused) << "\n";
+  if (!restart.empty())
+    std::cout << "Needs restart (initialize): " << join(restart) << "\n";
+}
+
+// Polls the config file's modification time; portable where inotify is not
+// (the emulator also builds on MSYS2)
+void CLI::start_config_watch() {
+  watching_ = true;
+  watch_thread_ = std::thread([this] {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    auto last = fs::last_write_time(config_path_, ec);
+    while (watching_.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      auto now = fs::last_write_time(config_path_, ec);
+      if (ec || now == last) continue;
+      last = now;
+      std::cout << "\n[config] " << config_path_ << " changed, reloading.\n";
+      reload_config();
+    }
+  });
+}
+
+void CLI::stop_config_watch() {
+  watching_ = false;
+  if (watch_thread_.joinable()) watch_thread_.join();
 }
 
 void CLI::attach_process_screen(const std::string& name, const std::shared_ptr<Process>& proc) {
@@ -105,13 +190,39 @@ void CLI::handle_screen_command(const std::vector<std::string>& args) {
 
   if (args.size() >= 3 && args[1] == "-s") {
     const std::string name = args[2];
+
+    Config cfg;
+    {
+      std::lock_guard<std::mutex> lock(cfg_mtx_);
+      cfg = cfg_;
+    }
+
+    // optional flags: -p <priority>, -d <deadline ticks>, -g <group>
+    uint32_t priority = cfg.min_priority;
+    uint32_t deadline = 0;
+    std::string group = cfg.screen_group;
+    for (size_t i = 3; i + 1 < args.size(); i += 2) {
+      try {
+        if (args[i] == "-p") priority = static_cast<uint32_t>(std::stoul(args[i + 1]));
+        else if (args[i] == "-d") deadline = static_cast<uint32_t>(std::stoul(args[i + 1]));
+        else if (args[i] == "-g") group = args[i + 1];
+        else { std::cout << "Unknown option " << args[i] << "\n"; return; }
+      } catch (...) {
+        std::cout << "Invalid value for " << args[i] << ": " << args[i + 1] << "\n";
+        return;
+      }
+    }
+
     uint32_t est = 0;
-    auto ins = generator_->generate_instructions(cfg_.min_ins, est);
+    auto ins = generator_->generate_instructions(cfg.min_ins, est);
 
     static uint32_t user_pid = 100000; // avoid collision with generator
     const uint32_t pid = user_pid++;
 
     auto p = std::make_shared<Process>(pid, name, ins);
+    p->priority = priority;
+    p->deadline = deadline;
+    p->group_id = scheduler_->group_id(group);
     screen_mgr_.create_screen(name, p);
     scheduler_->submit_process(p);
 
@@ -135,6 +246,111 @@ void CLI::handle_screen_command(const std::vector<std::string>& args) {
   std::cout << "Unknown screen subcommand.\n";
 }
 
+// cpu-online [id] / cpu-offline [id]. Without an id the lowest offline core
+// is onlined, or the highest online core is offlined.
+void CLI::handle_hotplug_command(const std::vector<std::string>& args, bool online) {
+  if (!require_init()) return;
+
+  uint32_t capacity = scheduler_->get_cpu_capacity();
+  int64_t cpu_id = -1;
+  if (args.size() >= 2) {
+    try { cpu_id = std::stoll(args[1]); } catch (...) { cpu_id = -1; }
+    if (cpu_id < 0) { std::cout << "Invalid core id: " << args[1] << "\n"; return; }
+  } else if (online) {
+    for (uint32_t i = 0; i < capacity && cpu_id < 0; ++i)
+      if (!scheduler_->is_cpu_online(i)) cpu_id = i;
+  } else {
+    for (int64_t i = capacity - 1; i >= 0 && cpu_id < 0; --i)
+      if (scheduler_->is_cpu_online(static_cast<uint32_t>(i))) cpu_id = i;
+  }
+
+  uint32_t id = static_cast<uint32_t>(cpu_id);
+  bool ok = cpu_id >= 0 && (online ? scheduler_->request_cpu_online(id)
+                                   : scheduler_->request_cpu_offline(id));
+  if (ok)
+    std::cout << "CPU " << id << (online ? " going online" : " going offline")
+              << " at the next tick.\n";
+  else if (cpu_id < 0 || id >= capacity)
+    std::cout << "No core to " << (online ? "online" : "offline")
+              << " (" << capacity << " core slots, set max-cpu for more).\n";
+  else
+    std::cout << "CPU " << id << " cannot go " << (online ? "online" : "offline")
+              << " (already " << (online ? "online" : "offline or the last online core") << ").\n";
+}
+
+// trace-replay <file>: the trace becomes the load source; the generator is
+// stopped until scheduler-start
+void CLI::start_trace_replay(const std::string& path) {
+  if (!require_init()) return;
+  stop_trace_replay();
+  generator_->stop();
+
+  Config cfg;
+  {
+    std::lock_guard<std::mutex> lock(cfg_mtx_);
+    cfg = cfg_;
+  }
+  trace_replay_ = new WorkloadReplay(*scheduler_, cfg);
+  std::string error;
+  if (!trace_replay_->start(path, error)) {
+    std::cout << "Cannot replay " << path << ": " << error << "\n";
+    stop_trace_replay();
+    return;
+  }
+  std::cout << "Replaying workload trace " << path << " (generator stopped; trace-status for progress).\n";
+}
+
+void CLI::stop_trace_replay() {
+  if (!trace_replay_) return;
+  trace_replay_->stop();
+  delete trace_replay_;
+  trace_replay_ = nullptr;
+}
+
+// shadow <policy> [quantum] attaches a what-if model of another policy to the
+// live workload; shadow prints the comparison, shadow off detaches it
+void CLI::handle_shadow_command(const std::vector<std::string>& args) {
+  if (!require_init()) return;
+  if (args.size() < 2) {
+    if (shadow_) std::cout << shadow_->report();
+    else std::cout << "No shadow scheduler. Usage: shadow <rr|fcfs|priority> [quantum-cycles] | shadow off\n";
+    return;
+  }
+  if (args[1] == "off") {
+    if (shadow_) std::cout << shadow_->report();
+    stop_shadow();
+    return;
+  }
+
+  Config cfg;
+  {
+    std::lock_guard<std::mutex> lock(cfg_mtx_);
+    cfg = cfg_;
+  }
+  SchedulingPolicy policy;
+  if (!parse_policy(args[1], policy) || (policy != RR && policy != FCFS && policy != PRIORITY)) {
+    std::cout << "Shadow policy must be rr, fcfs or priority.\n";
+    return;
+  }
+  uint32_t quantum = cfg.quantum_cycles;
+  if (args.size() >= 3) {
+    try { quantum = static_cast<uint32_t>(std::stoul(args[2])); }
+    catch (...) { std::cout << "Invalid quantum: " << args[2] << "\n"; return; }
+  }
+
+  stop_shadow();
+  shadow_ = new ShadowScheduler(*scheduler_, cfg, policy, quantum);
+  shadow_->start();
+  std::cout << "Shadow " << shadow_->describe() << " following processes that arrive from now on.\n";
+}
+
+void CLI::stop_shadow() {
+  if (!shadow_) return;
+  shadow_->stop();
+  delete shadow_;
+  shadow_ = nullptr;
+}
+
 int CLI::run() {
   print_banner();
   prompt();
@@ -142,41 +358,201 @@ int CLI::run() {
   std::string line;
 
   while (std::getline(std::cin, line)) {
-    const auto args = split(line);
-    if (args.empty()) { prompt(); continue; }
+    if (!handle_command(line)) break;
+    prompt();
+  }
 
-    const std::string cmd = to_lower(args[0]);
+  return 0;
+}
 
-    if (cmd == "exit") {
-      std::cout << "Goodbye.\n";
-      break;
+// Runs one CLI line; false when the line asks the CLI to exit
+bool CLI::handle_command(const std::string &line) {
+  const auto args = split(line);
+  if (args.empty()) return true;
+
+  const std::string cmd = to_lower(args[0]);
+
+  if (cmd == "exit" || cmd == "quit") {
+    std::cout << "Goodbye.\n";
+    return false;
+  }
+  else if (cmd == "initialize") {
+    initialize_system();
+  }
+  else if (cmd == "scheduler-start") {
+    if (require_init()) {
+      if (trace_replay_) std::cout << "Trace replay stopped.\n";
+      stop_trace_replay();
+      generator_->start();
     }
-    else if (cmd == "initialize") {
-      initialize_system();
+  }
+  else if (cmd == "scheduler-stop") {
+    if (require_init()) generator_->stop();
+  }
+  else if (cmd == "screen") {
+    handle_screen_command(args);
+  }
+  else if (cmd == "report-util") {
+    if (require_init()) {
+      std::cout << reporter_->build_report();
+      if (shadow_) std::cout << shadow_->report();
+      reporter_->write_log("csopesy-log.txt");
     }
-    else if (cmd == "scheduler-start") {
-      if (require_init()) generator_->start();
+  }
+  else if (cmd == "reload-config") {
+    reload_config();
+  }
+  else if (cmd == "cpu-online" || cmd == "cpu-offline") {
+    handle_hotplug_command(args, cmd == "cpu-online");
+  }
+  else if (cmd == "replay") {
+    // Independent of the running emulator; the trace carries its own workload
+    if (args.size() < 2) std::cout << "Usage: replay <trace file>\n";
+    else std::cout << replay_report(replay_sched_trace(args[1], load_config(config_path_)));
+  }
+  else if (cmd == "shadow") {
+    handle_shadow_command(args);
+  }
+  else if (cmd == "trace-replay") {
+    if (args.size() < 2) std::cout << "Usage: trace-replay <workload trace>\n";
+    else start_trace_replay(args[1]);
+  }
+  else if (cmd == "trace-status") {
+    if (!trace_replay_) std::cout << "No trace replay.\n";
+    else std::cout << workload_replay_report(trace_replay_->status());
+  }
+  else if (cmd == "lock-stats") {
+    if (args.size() > 1 && to_lower(args[1]) == "reset") {
+      reset_lock_stats();
+      std::cout << "Lock statistics reset.\n";
     }
-    else if (cmd == "scheduler-stop") {
-      if (require_init()) generator_->stop();
+    else std::cout << lock_stats_report();
+  }
+  else if (cmd == "sched-prof") {
+    if (require_init()) std::cout << scheduler_->tick_profile_report();
+  }
+  else if (cmd == "vmstat") {
+    if (require_init()) std::cout << scheduler_->opcode_stats_report();
+  }
+  else if (cmd == "trace-dump") {
+    if (!require_init()) return true;
+    Timeline *timeline = scheduler_->timeline();
+    if (!timeline) std::cout << "Timeline is off; set timeline-events in config.txt and initialize.\n";
+    else if (args.size() < 2) std::cout << "Usage: trace-dump <file.json>\n";
+    else {
+      int64_t written = write_chrome_trace(*timeline, args[1]);
+      if (written < 0) std::cout << "Cannot write " << args[1] << "\n";
+      else std::cout << "Wrote " << written << " trace events to " << args[1]
+                     << " (open in ui.perfetto.dev or chrome://tracing).\n";
     }
-    else if (cmd == "screen") {
-      handle_screen_command(args);
+  }
+  else if (cmd == "trace-stop") {
+    if (!trace_replay_) std::cout << "No trace replay.\n";
+    else {
+      std::cout << workload_replay_report(trace_replay_->status());
+      stop_trace_replay();
     }
-    else if (cmd == "report-util") {
-      if (require_init()) {
-        std::cout << reporter_->build_report();
-        reporter_->write_log("csopesy-log.txt");
-      }
+  }
+  else {
+    std::cout << "Unknown command: " << line << "\n";
+  }
+  return true;
+}
+
+void CLI::set_config_path(const std::string &path) { config_path_ = path; }
+
+static std::string json_escape(const std::string &s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\') { out += '\\'; out += c; }
+    else if (c == '\n') out += "\\n";
+    else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+    else out += c;
+  }
+  return out;
+}
+
+// Headless mode: runs the script, then waits for the stop conditions and
+// emits a one-line JSON summary (to opts.summary_path, or stdout).
+// Exit code 0 on success, 1 if the timeout cut the run short, 2 if the
+// script could not be read.
+int CLI::run_batch(const BatchOptions &opts) {
+  using clock = std::chrono::steady_clock;
+  auto ms_since = [](clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+  };
+
+  set_config_path(opts.config_path);
+  std::vector<std::string> script;
+  if (!opts.script_path.empty()) {
+    std::ifstream in(opts.script_path);
+    if (!in) {
+      std::cerr << "Cannot read script " << opts.script_path << "\n";
+      return 2;
     }
-    else {
-      std::cout << "Unknown command: " << line << "\n";
+    for (std::string line; std::getline(in, line); ) {
+      auto args = split(line);
+      if (!args.empty() && args[0][0] != '#') script.push_back(line);
     }
+  }
 
-    prompt();
+  const auto start = clock::now();
+  std::vector<std::pair<std::string, double>> timings;
+  bool exited = false;
+  for (const auto &line : script) {
+    auto t0 = clock::now();
+    bool keep_going = handle_command(line);
+    timings.push_back({line, ms_since(t0)});
+    if (!keep_going) { exited = true; break; }
   }
 
-  return 0;
-}
+  // Stop conditions need a running emulator even if the script never
+  // initialized one
+  bool waits = opts.run_ticks > 0 || opts.until_idle;
+  if (!exited && waits && !initialized_) initialize_system();
+
+  std::string stop_reason = exited ? "exit" : "script-end";
+  uint32_t first_tick = initialized_ ? scheduler_->current_tick() : 0;
+  auto timed_out = [&] { return opts.timeout_s > 0 && ms_since(start) >= opts.timeout_s * 1000.0; };
+  auto nap = [] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); };
 
-void CLI::handle_command(const std::string &cmd) { (void)cmd; }
+  if (!exited && opts.run_ticks > 0) {
+    while (scheduler_->current_tick() - first_tick < opts.run_ticks && !timed_out()) nap();
+    stop_reason = "run-ticks";
+  }
+  if (!exited && opts.until_idle && !timed_out()) {
+    generator_->stop(); // otherwise new jobs keep arriving
+    while (trace_replay_ && !trace_replay_->done() && !timed_out()) nap();
+    while (!scheduler_->is_idle() && !timed_out()) nap();
+    stop_reason = "until-idle";
+  }
+  bool hit_timeout = waits && timed_out();
+  if (hit_timeout) stop_reason = "timeout";
+
+  double wall_ms = ms_since(start);
+  uint32_t ticks = initialized_ ? scheduler_->current_tick() - first_tick : 0;
+  if (initialized_) generator_->stop();
+
+  std::ostringstream json;
+  json << std::fixed << std::setprecision(3);
+  json << "{\"config\":\"" << json_escape(opts.config_path) << "\""
+       << ",\"script\":\"" << json_escape(opts.script_path) << "\""
+       << ",\"stop_reason\":\"" << stop_reason << "\""
+       << ",\"wall_ms\":" << wall_ms
+       << ",\"ticks\":" << ticks
+       << ",\"ticks_per_sec\":" << (wall_ms > 0 ? ticks * 1000.0 / wall_ms : 0.0)
+       << ",\"finished\":" << (initialized_ ? scheduler_->finished_count() : 0)
+       << ",\"commands\":[";
+  for (size_t i = 0; i < timings.size(); ++i)
+    json << (i ? "," : "") << "{\"cmd\":\"" << json_escape(timings[i].first)
+         << "\",\"ms\":" << timings[i].second << "}";
+  json << "]}\n";
+
+  if (opts.summary_path.empty()) {
+    std::cout << json.str();
+  } else {
+    std::ofstream out(opts.summary_path);
+    out << json.str();
+  }
+  return hit_timeout ? 1 : 0;
+}
@@ -1,8 +1,10 @@
 #include "../include/config.hpp"
 #include <fstream>
+#include <iostream>
 #include <sstream>
 #include <string>
 #include <algorithm>
+#include <stdexcept>
 
 static std::string trim(std::string s) {
   auto notspace = [](int ch){ return !std::isspace(ch); };
@@ -11,6 +13,209 @@ static std::string trim(std::string s) {
   return s;
 }
 
+// config.txt values may be quoted, e.g. scheduler "rr"
+static std::string unquote(std::string s) {
+  if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
+    return s.substr(1, s.size() - 2);
+  return s;
+}
+
+static bool parse_bool(std::string v) {
+  std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+  return v == "1" || v == "true" || v == "on" || v == "yes";
+}
+
+// Comma separated list of unsigned integers, e.g. 1,2,4
+static std::vector<uint32_t> parse_uint_list(const std::string &v) {
+  std::vector<uint32_t> out;
+  std::istringstream iss(v);
+  for (std::string tok; std::getline(iss, tok, ','); ) {
+    tok = trim(tok);
+    if (!tok.empty()) out.push_back(static_cast<uint32_t>(std::stoul(tok)));
+  }
+  return out;
+}
+
+// name:share:quota_pct, e.g. batch:1:60 (share and quota optional)
+static GroupConfig parse_group(const std::string &v) {
+  GroupConfig g;
+  std::istringstream iss(v);
+  std::string tok;
+  std::getline(iss, g.name, ':');
+  if (std::getline(iss, tok, ':') && !tok.empty()) g.share = std::max<uint32_t>(1, std::stoul(tok));
+  if (std::getline(iss, tok, ':') && !tok.empty()) g.quota_pct = std::min<uint32_t>(100, std::stoul(tok));
+  return g;
+}
+
+// Named instruction mixes for profile.<name>.mix, in InstructionType order
+static std::vector<uint32_t> parse_mix(const std::string &v) {
+  if (v == "uniform") return {1, 1, 1, 1, 1, 1};
+  if (v == "print-heavy") return {6, 1, 1, 1, 1, 1};
+  if (v == "sleep-heavy") return {1, 1, 1, 1, 6, 1};
+  if (v == "arith-heavy") return {1, 2, 4, 4, 1, 1};
+  auto mix = parse_uint_list(v);
+  mix.resize(6, 0);
+  return mix;
+}
+
+// profile.<name>.<field> <value>; the profile is created on first use
+static void parse_profile_key(std::vector<WorkloadProfile> &profiles,
+                              const std::string &key, const std::string &value) {
+  auto dot = key.find('.', 8);
+  if (dot == std::string::npos) return;
+  std::string name = key.substr(8, dot - 8), field = key.substr(dot + 1);
+
+  auto it = std::find_if(profiles.begin(), profiles.end(),
+                         [&](const WorkloadProfile &p) { return p.name == name; });
+  if (it == profiles.end()) {
+    profiles.push_back(WorkloadProfile{});
+    profiles.back().name = name;
+    it = profiles.end() - 1;
+  }
+  WorkloadProfile &p = *it;
+  std::string v = value;
+  std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+  auto range = [&](uint32_t &lo, uint32_t &hi) {
+    auto r = parse_uint_list(v);
+    if (!r.empty()) lo = hi = r[0];
+    if (r.size() > 1) hi = r[1];
+  };
+
+  if (field == "arrival") p.arrival = v;
+  else if (field == "interval") p.interval = static_cast<uint32_t>(std::stoul(v));
+  else if (field == "batch") p.batch = std::max<uint32_t>(1, std::stoul(v));
+  else if (field == "burst-size") p.burst_size = std::max<uint32_t>(1, std::stoul(v));
+  else if (field == "ins") p.ins_dist = v;
+  else if (field == "pareto-alpha") p.pareto_alpha = std::max(0.1, std::stod(v));
+  else if (field == "min-ins") p.min_ins = static_cast<uint32_t>(std::stoul(v));
+  else if (field == "max-ins") p.max_ins = static_cast<uint32_t>(std::stoul(v));
+  else if (field == "mix") p.mix = parse_mix(v);
+  else if (field == "for-depth") p.for_depth = std::min<uint32_t>(FOR_MAX_NESTING, std::stoul(v));
+  else if (field == "for-repeats") range(p.for_min_repeats, p.for_max_repeats);
+  else if (field == "for-body") range(p.for_min_body, p.for_max_body);
+}
+
+WorkloadProfile active_workload(const Config &cfg) {
+  WorkloadProfile p;
+  for (const auto &candidate : cfg.profiles)
+    if (candidate.name == cfg.workload) p = candidate;
+  if (!p.interval) p.interval = cfg.batch_process_freq;
+  if (!p.min_ins) p.min_ins = cfg.min_ins;
+  if (!p.max_ins) p.max_ins = cfg.max_ins;
+  p.max_ins = std::max(p.min_ins, p.max_ins);
+  p.for_min_body = std::max<uint32_t>(1, p.for_min_body);
+  return p;
+}
+
+bool parse_policy(const std::string &name, SchedulingPolicy &out) {
+  std::string v = name;
+  std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+  if (v == "rr")        out = SchedulingPolicy::RR;
+  else if (v == "fcfs") out = SchedulingPolicy::FCFS;
+  else if (v == "priority" || v == "prio") out = SchedulingPolicy::PRIORITY;
+  else if (v == "mlfq") out = SchedulingPolicy::MLFQ;
+  else if (v == "cfs") out = SchedulingPolicy::CFS;
+  else if (v == "edf") out = SchedulingPolicy::EDF;
+  else return false;
+  return true;
+}
+
+bool parse_deadline_admission(const std::string &name, DeadlineAdmission &out) {
+  std::string v = name;
+  std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+  if (v == "none")        out = DeadlineAdmission::NONE;
+  else if (v == "flag")   out = DeadlineAdmission::FLAG;
+  else if (v == "reject") out = DeadlineAdmission::REJECT;
+  else return false;
+  return true;
+}
+
+std::string policy_name(SchedulingPolicy policy) {
+  static const char *const kNames[] = {"RR", "FCFS", "PRIORITY", "MLFQ", "CFS", "EDF"};
+  return static_cast<size_t>(policy) < 6 ? kNames[policy] : "UNKNOWN";
+}
+
+// One config.txt line; load_config ignores unknown keys
+bool set_config_key(Config &cfg, std::string key, std::string value) {
+  key = trim(key), value = unquote(trim(value));
+
+  if (key == "num-cpu")
+    cfg.num_cpu = static_cast<uint32_t>(std::stoul(value));
+
+  else if (key == "scheduler") {
+    if (!parse_policy(value, cfg.scheduler)) cfg.scheduler = SchedulingPolicy::FCFS;
+  }
+
+  else if (key == "quantum-cycles") cfg.quantum_cycles = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "batch-process-freq") cfg.batch_process_freq = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "min-ins") cfg.min_ins = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "max-ins") cfg.max_ins = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "scheduler-tick-delay") cfg.scheduler_tick_delay = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "max-unrolled-instructions") cfg.max_unrolled_instructions = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "delay-per-exec") cfg.delay_per_exec = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "snapshot-cooldown") cfg.snapshot_cooldown = static_cast<uint32_t>(std::stoul(value));
+
+  else if (key == "min-priority") cfg.min_priority = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "max-priority") cfg.max_priority = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "priority-weights") cfg.priority_weights = parse_uint_list(value);
+  else if (key == "priority-preempt") cfg.priority_preempt = parse_bool(value);
+  else if (key == "aging-ticks") cfg.aging_ticks = static_cast<uint32_t>(std::stoul(value));
+
+  else if (key == "mlfq-levels") cfg.mlfq_levels = std::max<uint32_t>(1, static_cast<uint32_t>(std::stoul(value)));
+  else if (key == "mlfq-quanta") cfg.mlfq_quanta = parse_uint_list(value);
+  else if (key == "mlfq-boost-ticks") cfg.mlfq_boost_ticks = static_cast<uint32_t>(std::stoul(value));
+
+  else if (key == "cfs-min-granularity") cfg.cfs_min_granularity = std::max<uint32_t>(1, static_cast<uint32_t>(std::stoul(value)));
+
+  else if (key == "min-deadline") cfg.min_deadline = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "max-deadline") cfg.max_deadline = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "deadline-admission") {
+    if (!parse_deadline_admission(value, cfg.deadline_admission))
+      throw std::invalid_argument("expected none, flag or reject");
+  }
+
+  else if (key == "cgroup") cfg.groups.push_back(parse_group(value));
+  else if (key == "cgroup-period") cfg.group_period = std::max<uint32_t>(1, static_cast<uint32_t>(std::stoul(value)));
+  else if (key == "generator-group") cfg.generator_group = value;
+  else if (key == "screen-group") cfg.screen_group = value;
+
+  else if (key == "max-cpu") cfg.max_cpu = static_cast<uint32_t>(std::stoul(value));
+
+  else if (key == "affinity") cfg.affinity = parse_bool(value);
+  else if (key == "affinity-window") cfg.affinity_window = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "cache-cold-penalty") cfg.cache_cold_penalty = static_cast<uint32_t>(std::stoul(value));
+
+  else if (key == "watch-config") cfg.watch_config = parse_bool(value);
+
+  else if (key == "seed") cfg.seed = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "record-trace") cfg.record_trace = value;
+  else if (key == "timeline-events") cfg.timeline_events = static_cast<uint32_t>(std::stoul(value));
+  else if (key == "opcode-profile") cfg.opcode_profile = parse_bool(value);
+  else if (key == "opcode-sample") cfg.opcode_sample = static_cast<uint32_t>(std::stoul(value));
+
+  else if (key == "workload") cfg.workload = value;
+  else if (key.rfind("profile.", 0) == 0) parse_profile_key(cfg.profiles, key, value);
+
+  else if (key == "pin-scheduler") {
+    std::string v=value; std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+    cfg.pin_scheduler = (v == "none" || v.empty()) ? -1 : std::stoi(v);
+  }
+  else if (key == "pin-workers") {
+    std::string v=value; std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+    if (v == "none" || v == "compact" || v == "scatter") cfg.pin_workers = v;
+    else { cfg.pin_workers = "list"; cfg.pin_worker_cpus = parse_uint_list(v); }
+  }
+  else return false;
+  return true;
+}
+
+// Keys may come in any order, so cross-key limits are applied once the
+// whole file is read. Weights past max-priority would draw levels above it.
+static void clamp_to_ranges(Config &cfg) {
+  uint32_t levels = (cfg.max_priority > cfg.min_priority ? cfg.max_priority - cfg.min_priority : 0) + 1;
+  if (cfg.priority_weights.size() > levels) cfg.priority_weights.resize(levels);
+}
+
 Config load_config(const std::string &path) {
 
   Config cfg{};
@@ -23,27 +228,111 @@ Config load_config(const std::string &path) {
 
   std::string key, value;
 
-  while (in >> key >> value) 
-  {
-    key = trim(key), value = trim(value);
-
-    if (key == "num-cpu")
-      cfg.num_cpu = static_cast<uint32_t>(std::stoul(value));
-
-    else if (key == "scheduler") {
-      std::string v=value; std::transform(v.begin(), v.end(), v.begin(), ::tolower);
-      
-      if (v == "rr")        cfg.scheduler = SchedulingPolicy::RR;
-      else if (v == "fcfs") cfg.scheduler = SchedulingPolicy::FCFS;
-      else cfg.scheduler = SchedulingPolicy::FCFS;
+  while (in >> key >> value) {
+    try {
+      set_config_key(cfg, key, value);
+    } catch (const std::exception &e) {
+      std::cerr << path << ": bad value " << value << " for " << key << " (" << e.what() << "); keeping the default\n";
     }
-
-    else if (key == "quantum-cycles") cfg.quantum_cycles = static_cast<uint32_t>(std::stoul(value));
-    else if (key == "batch-process-freq") cfg.batch_process_freq = static_cast<uint32_t>(std::stoul(value));
-    else if (key == "min-ins") cfg.min_ins = static_cast<uint32_t>(std::stoul(value));
-    else if (key == "max-ins") cfg.max_ins = static_cast<uint32_t>(std::stoul(value));
-    else if (key == "delay-per-exec") cfg.delay_per_exec = static_cast<uint32_t>(std::stoul(value));
-    else if (key == "snapshot-cooldown") cfg.snapshot_cooldown = static_cast<uint32_t>(std::stoul(value));
   }
+  clamp_to_ranges(cfg);
   return cfg;
 }
+
+// One entry per config.txt key: how to tell whether it changed and whether
+// a running emulator can take the new value
+struct KeyInfo {
+  const char *key;
+  bool live;
+  bool (*differs)(const Config &, const Config &);
+};
+
+#define CONFIG_KEY(key, live, member) \
+  {key, live, [](const Config &a, const Config &b) { return a.member != b.member; }}
+
+static const KeyInfo kKeys[] = {
+  CONFIG_KEY("num-cpu", false, num_cpu),
+  CONFIG_KEY("max-cpu", false, max_cpu),
+  CONFIG_KEY("scheduler", false, scheduler),
+  CONFIG_KEY("quantum-cycles", true, quantum_cycles),
+  CONFIG_KEY("batch-process-freq", true, batch_process_freq),
+  CONFIG_KEY("min-ins", true, min_ins),
+  CONFIG_KEY("max-ins", true, max_ins),
+  CONFIG_KEY("delay-per-exec", true, delay_per_exec),
+  CONFIG_KEY("scheduler-tick-delay", true, scheduler_tick_delay),
+  CONFIG_KEY("max-unrolled-instructions", true, max_unrolled_instructions),
+  CONFIG_KEY("snapshot-cooldown", true, snapshot_cooldown),
+  CONFIG_KEY("min-priority", true, min_priority),
+  CONFIG_KEY("max-priority", true, max_priority),
+  CONFIG_KEY("priority-weights", true, priority_weights),
+  CONFIG_KEY("priority-preempt", true, priority_preempt),
+  CONFIG_KEY("aging-ticks", true, aging_ticks),
+  CONFIG_KEY("mlfq-levels", false, mlfq_levels),
+  CONFIG_KEY("mlfq-quanta", false, mlfq_quanta),
+  CONFIG_KEY("mlfq-boost-ticks", true, mlfq_boost_ticks),
+  CONFIG_KEY("cfs-min-granularity", true, cfs_min_granularity),
+  CONFIG_KEY("min-deadline", true, min_deadline),
+  CONFIG_KEY("max-deadline", true, max_deadline),
+  CONFIG_KEY("deadline-admission", true, deadline_admission),
+  CONFIG_KEY("cgroup", false, groups),
+  CONFIG_KEY("cgroup-period", false, group_period),
+  CONFIG_KEY("generator-group", false, generator_group),
+  CONFIG_KEY("screen-group", false, screen_group),
+  CONFIG_KEY("affinity", true, affinity),
+  CONFIG_KEY("affinity-window", true, affinity_window),
+  CONFIG_KEY("cache-cold-penalty", true, cache_cold_penalty),
+  CONFIG_KEY("pin-scheduler", false, pin_scheduler),
+  CONFIG_KEY("pin-workers", false, pin_workers),
+  CONFIG_KEY("watch-config", false, watch_config),
+  CONFIG_KEY("seed", false, seed),
+  CONFIG_KEY("record-trace", false, record_trace),
+  CONFIG_KEY("timeline-events", false, timeline_events),
+  CONFIG_KEY("opcode-profile", false, opcode_profile),
+  CONFIG_KEY("opcode-sample", false, opcode_sample),
+  CONFIG_KEY("workload", true, workload),
+  CONFIG_KEY("profile", true, profiles),
+};
+
+#undef CONFIG_KEY
+
+std::vector<std::string> changed_keys(const Config &a, const Config &b) {
+  std::vector<std::string> out;
+  for (const auto &k : kKeys)
+    if (k.differs(a, b)) out.push_back(k.key);
+  if (a.pin_worker_cpus != b.pin_worker_cpus &&
+      std::find(out.begin(), out.end(), "pin-workers") == out.end())
+    out.push_back("pin-workers");
+  return out;
+}
+
+bool is_live_key(const std::string &key) {
+  for (const auto &k : kKeys)
+    if (key == k.key) return k.live;
+  return false;
+}
+
+void apply_live_keys(Config &dst, const Config &src) {
+  dst.quantum_cycles = std::max<uint32_t>(1, src.quantum_cycles);
+  dst.batch_process_freq = src.batch_process_freq;
+  dst.min_ins = src.min_ins;
+  dst.max_ins = src.max_ins;
+  dst.delay_per_exec = src.delay_per_exec;
+  dst.scheduler_tick_delay = src.scheduler_tick_delay;
+  dst.max_unrolled_instructions = src.max_unrolled_instructions;
+  dst.snapshot_cooldown = std::max<uint32_t>(1, src.snapshot_cooldown);
+  dst.min_priority = src.min_priority;
+  dst.max_priority = src.max_priority;
+  dst.priority_weights = src.priority_weights;
+  dst.priority_preempt = src.priority_preempt;
+  dst.aging_ticks = src.aging_ticks;
+  dst.mlfq_boost_ticks = src.mlfq_boost_ticks;
+  dst.cfs_min_granularity = src.cfs_min_granularity;
+  dst.min_deadline = src.min_deadline;
+  dst.max_deadline = src.max_deadline;
+  dst.deadline_admission = src.deadline_admission;
+  dst.affinity = src.affinity;
+  dst.affinity_window = src.affinity_window;
+  dst.cache_cold_penalty = src.cache_cold_penalty;
+  dst.workload = src.workload;
+  dst.profiles = src.profiles;
+}
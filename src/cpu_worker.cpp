@@ -1,6 +1,7 @@
 #include "../include/cpu_worker.hpp"
 #include "../include/process.hpp"
 #include "../include/scheduler.hpp"
+#include "../include/thread_pinning.hpp"
 #include <iostream>
 
 #define DEBUG_CPU_WORKER false
@@ -29,7 +30,10 @@ void CPUWorker::stop() {
   std::cout << "CPU Worker " << id_ << " stopping.\n";
 #endif
   running_.store(false);
-  sched_.stop_barrier_sync();
+}
+
+bool CPUWorker::pin(int host_cpu) {
+  return pin_thread(thread_, host_cpu);
 }
 
 void CPUWorker::join() {
@@ -39,31 +43,36 @@ void CPUWorker::join() {
 }
 
 void CPUWorker::loop() {
-  while (running_.load()) {
+  while (true) {
 
     while (sched_.is_paused()) std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
-    sched_.tick_barrier_sync();
-
-    auto process = sched_.dispatch_to_cpu(this->id_);
-
-    uint32_t consumed_ticks = 1; // max ticks possible in one execute_tick call
-
-    if (!process) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(5));
-      sched_.tick_barrier_sync();
-      sched_.tick_barrier_sync();
-      continue;
+    sched_.tick_barrier_sync(this->id_);
+    if (!running_.load()) { // offlined, or stopped by the scheduler's final barrier
+      sched_.stop_barrier_sync();
+      break;
     }
 
-    ProcessReturnContext context = process->execute_tick(
-        sched_.current_tick(), 
-        sched_.get_scheduler_tick_delay(),
-        consumed_ticks);
-
-    if (is_yielded(context)) sched_.release_cpu_interrupt(this->id_, process, context);
+    // Published by the scheduler thread before the barrier; no lock needed
+    Process *process = sched_.assigned_process(this->id_);
+
+    if (process) {
+      uint32_t consumed_ticks = 1; // max ticks possible in one execute_tick call
+      ProcessReturnContext context = process->execute_tick(
+          sched_.current_tick(), 
+          sched_.get_delay_per_exec(),
+          consumed_ticks,
+          sched_.opcode_profile(this->id_));
+
+      if (is_yielded(context)) {
+        if (Timeline *timeline = sched_.timeline())
+          timeline->core(this->id_, TimelineKind::YIELD, sched_.current_tick(), process->id());
+        sched_.post_core_event(this->id_, std::move(context));
+      }
+    }
+    sched_.account_core_tick(this->id_, process != nullptr);
 
-    sched_.tick_barrier_sync();
-    sched_.tick_barrier_sync(); // Here, scheduler increases timer. Second tick barrier is essential
+    sched_.tick_barrier_sync(this->id_);
+    sched_.tick_barrier_sync(this->id_); // Here, scheduler increases timer. Second tick barrier is essential
   }
 }
@@ -4,7 +4,7 @@
 #include <ctime>
 
 void FinishedMap::insert(ProcessPtr p, uint32_t finished_tick){
-  std::scoped_lock<std::mutex> lock(mutex_);
+  std::scoped_lock<TrackedMutex> lock(mutex_);
   // ensure unique name if duplicates
   rename_process(p);
   finished_by_name_[p->name()] = p;
@@ -13,18 +13,18 @@ void FinishedMap::insert(ProcessPtr p, uint32_t finished_tick){
 }
 
 ProcessPtr FinishedMap::get_by_name(const std::string& name){
-  std::scoped_lock<std::mutex> lock(mutex_);
+  std::scoped_lock<TrackedMutex> lock(mutex_);
   auto it = finished_by_name_.find(name);
   return (it==finished_by_name_.end()) ? nullptr : it->second;
 }
 
 bool FinishedMap::contains(const std::string& name){
-  std::scoped_lock<std::mutex> lock(mutex_);
+  std::scoped_lock<TrackedMutex> lock(mutex_);
   return finished_by_name_.count(name) != 0;
 }
 
 std::vector<OrderedEntry> FinishedMap::ordered(){
-  std::scoped_lock<std::mutex> lock(mutex_);
+  std::scoped_lock<TrackedMutex> lock(mutex_);
   std::vector<OrderedEntry> out;
   out.reserve(finished_by_tick_.size());
   for (auto &kv : finished_by_tick_){
@@ -36,7 +36,7 @@ std::vector<OrderedEntry> FinishedMap::ordered(){
 }
 
 void FinishedMap::clear(){
-  std::scoped_lock<std::mutex> lock(mutex_);
+  std::scoped_lock<TrackedMutex> lock(mutex_);
   finished_by_name_.clear();
   finished_by_tick_.clear();
   finished_by_time_.clear();
@@ -44,12 +44,12 @@ void FinishedMap::clear(){
 }
 
 size_t FinishedMap::size(){
-  std::scoped_lock<std::mutex> lock(mutex_);
+  std::scoped_lock<TrackedMutex> lock(mutex_);
   return finished_by_name_.size();
 }
 
 std::string FinishedMap::snapshot(){
-  std::scoped_lock<std::mutex> lock(mutex_);
+  std::scoped_lock<TrackedMutex> lock(mutex_);
   std::ostringstream oss;
   if (finished_by_tick_.empty()) return {};
   for (auto &kv : finished_by_tick_){
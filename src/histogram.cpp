@@ -0,0 +1,91 @@
+#include "../include/histogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <sstream>
+
+size_t LogLinearHistogram::bucket_of(uint64_t value) {
+  if (value < kSubBuckets) return static_cast<size_t>(value);
+  uint32_t exp = 63 - static_cast<uint32_t>(std::countl_zero(value)); // >= kSubBucketBits
+  uint32_t shift = exp - kSubBucketBits;
+  uint64_t sub = (value >> shift) - kSubBuckets;                      // 0..kSubBuckets-1
+  return (shift + 1) * kSubBuckets + static_cast<size_t>(sub);
+}
+
+uint64_t LogLinearHistogram::bucket_upper(size_t bucket) {
+  if (bucket < kSubBuckets) return bucket;
+  uint32_t shift = static_cast<uint32_t>(bucket / kSubBuckets) - 1;
+  uint64_t sub = bucket % kSubBuckets + kSubBuckets;
+  return ((sub + 1) << shift) - 1;
+}
+
+void LogLinearHistogram::record(uint64_t value, uint64_t count) {
+  counts_[bucket_of(value)] += count;
+  count_ += count;
+  sum_ += value * count;
+  max_ = std::max(max_, value);
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram &other) {
+  for (size_t i = 0; i < kBuckets; ++i) counts_[i] += other.counts_[i];
+  count_ += other.count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+// `max` keeps the all-time value; everything else becomes the difference
+void LogLinearHistogram::subtract(const LogLinearHistogram &earlier) {
+  for (size_t i = 0; i < kBuckets; ++i) counts_[i] -= std::min(counts_[i], earlier.counts_[i]);
+  count_ -= std::min(count_, earlier.count_);
+  sum_ -= std::min(sum_, earlier.sum_);
+}
+
+void LogLinearHistogram::clear() {
+  counts_.fill(0);
+  count_ = sum_ = max_ = 0;
+}
+
+uint64_t LogLinearHistogram::percentile(double q) const {
+  if (count_ == 0) return 0;
+  uint64_t rank = static_cast<uint64_t>(q * count_ + 0.5);
+  rank = std::clamp<uint64_t>(rank, 1, count_);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) return std::min(bucket_upper(i), max_);
+  }
+  return max_;
+}
+
+std::string LogLinearHistogram::summary() const {
+  std::ostringstream oss;
+  oss << "n=" << count_ << " mean=" << std::fixed << std::setprecision(1) << mean()
+      << " p50=" << percentile(0.50) << " p90=" << percentile(0.90)
+      << " p99=" << percentile(0.99) << " max=" << max_;
+  return oss.str();
+}
+
+// === Atomic Variant ===
+
+void AtomicLogLinearHistogram::record(uint64_t value) {
+  relaxed_add(counts_[LogLinearHistogram::bucket_of(value)], 1);
+  relaxed_add(sum_, value);
+  if (value > max_.load(std::memory_order_relaxed)) max_.store(value, std::memory_order_relaxed);
+}
+
+void AtomicLogLinearHistogram::clear() {
+  for (auto &c : counts_) c.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+LogLinearHistogram AtomicLogLinearHistogram::snapshot() const {
+  LogLinearHistogram h;
+  for (size_t i = 0; i < LogLinearHistogram::kBuckets; ++i) {
+    h.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+    h.count_ += h.counts_[i];
+  }
+  h.sum_ = sum_.load(std::memory_order_relaxed);
+  h.max_ = max_.load(std::memory_order_relaxed);
+  return h;
+}
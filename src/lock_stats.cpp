@@ -0,0 +1,114 @@
+#include "../include/lock_stats.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+
+// Sites live in a deque so their addresses stay valid as more register.
+// Registration happens when a mutex is constructed, never on lock().
+static std::mutex registry_mtx;
+static std::deque<LockSite> &registry() {
+  static std::deque<LockSite> sites;
+  return sites;
+}
+
+LockSite *lock_site(const char *name) {
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  for (auto &site : registry())
+    if (std::strcmp(site.name, name) == 0) return &site;
+  registry().emplace_back().name = name;
+  return &registry().back();
+}
+
+static void raise_max(std::atomic<uint64_t> &max, uint64_t value) {
+  uint64_t seen = max.load(std::memory_order_relaxed);
+  while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+static uint64_t since(std::chrono::steady_clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t).count();
+}
+
+// === ProfiledMutex ===
+
+void ProfiledMutex::lock() {
+  if (!m_.try_lock()) {
+    auto begin = std::chrono::steady_clock::now();
+    m_.lock();
+    uint64_t waited = since(begin);
+    site_->contended.fetch_add(1, std::memory_order_relaxed);
+    site_->wait_ns.fetch_add(waited, std::memory_order_relaxed);
+    raise_max(site_->max_wait_ns, waited);
+  }
+  site_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+  acquired_at_ = std::chrono::steady_clock::now();
+}
+
+bool ProfiledMutex::try_lock() {
+  if (!m_.try_lock()) return false;
+  site_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+  acquired_at_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+void ProfiledMutex::unlock() {
+  uint64_t held = since(acquired_at_);
+  m_.unlock();
+  site_->hold_ns.fetch_add(held, std::memory_order_relaxed);
+  raise_max(site_->max_hold_ns, held);
+}
+
+// === Reporting ===
+
+std::vector<LockSiteStats> lock_stats() {
+  std::vector<LockSiteStats> out;
+  {
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    for (const auto &site : registry()) {
+      uint64_t acquisitions = site.acquisitions.load(std::memory_order_relaxed);
+      if (!acquisitions) continue;
+      out.push_back({site.name, acquisitions, site.contended.load(std::memory_order_relaxed),
+                     site.wait_ns.load(std::memory_order_relaxed), site.max_wait_ns.load(std::memory_order_relaxed),
+                     site.hold_ns.load(std::memory_order_relaxed), site.max_hold_ns.load(std::memory_order_relaxed)});
+    }
+  }
+  std::stable_sort(out.begin(), out.end(), [](const LockSiteStats &a, const LockSiteStats &b) {
+    return a.wait_ns != b.wait_ns ? a.wait_ns > b.wait_ns : a.contended > b.contended;
+  });
+  return out;
+}
+
+void reset_lock_stats() {
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  for (auto &site : registry()) {
+    site.acquisitions.store(0, std::memory_order_relaxed);
+    site.contended.store(0, std::memory_order_relaxed);
+    site.wait_ns.store(0, std::memory_order_relaxed);
+    site.max_wait_ns.store(0, std::memory_order_relaxed);
+    site.hold_ns.store(0, std::memory_order_relaxed);
+    site.max_hold_ns.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::string lock_stats_report() {
+  if (!LOCK_STATS) return "Lock statistics are not compiled in; rebuild with make LOCK_STATS=1\n";
+  std::vector<LockSiteStats> sites = lock_stats();
+  if (sites.empty()) return "No lock acquisitions recorded\n";
+
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1);
+  oss << "Lock sites (most total wait first)\n"
+      << "  " << std::left << std::setw(24) << "site" << std::right << std::setw(12) << "acquired"
+      << std::setw(11) << "contended" << std::setw(8) << "cont%" << std::setw(11) << "wait ms"
+      << std::setw(13) << "max wait us" << std::setw(11) << "hold ms" << std::setw(13) << "mean hold ns"
+      << std::setw(13) << "max hold us" << "\n";
+  for (const auto &s : sites) {
+    oss << "  " << std::left << std::setw(24) << s.name << std::right << std::setw(12) << s.acquisitions
+        << std::setw(11) << s.contended << std::setw(7) << 100.0 * s.contended / s.acquisitions << "%"
+        << std::setw(11) << s.wait_ns / 1e6 << std::setw(13) << s.max_wait_ns / 1e3
+        << std::setw(11) << s.hold_ns / 1e6 << std::setw(13) << static_cast<double>(s.hold_ns) / s.acquisitions
+        << std::setw(13) << s.max_hold_ns / 1e3 << "\n";
+  }
+  return oss.str();
+}
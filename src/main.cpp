@@ -1,6 +1,86 @@
 #include "../include/cli.hpp"
+#include "../include/sweep.hpp"
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+static void usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0 << " [--config PATH] [--script FILE] [--run-ticks N]\n"
+            << "       [--until-idle] [--timeout SECONDS] [--summary FILE]\n"
+            << "       " << argv0 << " [--config PATH] --sweep KEY=V1,V2... [--sweep ...]\n"
+            << "       [--processes N | --workload-trace FILE] [--jobs N] [--max-ticks N] [--summary FILE]\n"
+            << "Without --script, --run-ticks, --until-idle or --sweep the interactive prompt starts.\n";
+}
+
+// Discards the schedulers' console output while a sweep runs
+struct NullBuffer : std::streambuf {
+  int overflow(int c) override { return c; }
+};
+
+// Prints the sweep table; --summary writes it as CSV. Exit code 2 on bad
+// options or workload, 1 if some point did not finish within --max-ticks.
+static int run_sweep_mode(SweepOptions opts, const std::string &csv_path) {
+  std::string error;
+  std::vector<SweepPoint> points;
+  NullBuffer null;
+  std::streambuf *console = std::cout.rdbuf(&null);
+  bool ok = run_sweep(opts, points, error);
+  std::cout.rdbuf(console);
+  if (!ok) {
+    std::cerr << "Sweep failed: " << error << "\n";
+    return 2;
+  }
+
+  std::cout << sweep_table(opts, points);
+  if (!csv_path.empty()) std::ofstream(csv_path) << sweep_csv(opts, points);
+  for (const auto &p : points)
+    if (!p.completed) return 1;
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  BatchOptions opts;
+  SweepOptions sweep;
+  bool batch = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    try {
+      if (arg == "--config" && has_value) opts.config_path = argv[++i];
+      else if (arg == "--script" && has_value) { opts.script_path = argv[++i]; batch = true; }
+      else if (arg == "--run-ticks" && has_value) { opts.run_ticks = static_cast<uint32_t>(std::stoul(argv[++i])); batch = true; }
+      else if (arg == "--until-idle") { opts.until_idle = true; batch = true; }
+      else if (arg == "--timeout" && has_value) opts.timeout_s = static_cast<uint32_t>(std::stoul(argv[++i]));
+      else if (arg == "--summary" && has_value) opts.summary_path = argv[++i];
+      else if (arg == "--sweep" && has_value) {
+        SweepAxis axis;
+        std::string error;
+        if (!parse_sweep_axis(argv[++i], axis, error)) {
+          std::cerr << error << "\n";
+          return 2;
+        }
+        sweep.grid.push_back(axis);
+      }
+      else if (arg == "--processes" && has_value) sweep.processes = static_cast<uint32_t>(std::stoul(argv[++i]));
+      else if (arg == "--workload-trace" && has_value) sweep.workload_trace = argv[++i];
+      else if (arg == "--jobs" && has_value) sweep.jobs = static_cast<uint32_t>(std::stoul(argv[++i]));
+      else if (arg == "--max-ticks" && has_value) sweep.max_ticks = static_cast<uint32_t>(std::stoul(argv[++i]));
+      else { usage(argv[0]); return 2; }
+    } catch (...) {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (!sweep.grid.empty()) {
+    sweep.base = load_config(opts.config_path);
+    return run_sweep_mode(sweep, opts.summary_path);
+  }
 
-int main() {
   CLI cli;
+  if (batch) return cli.run_batch(opts);
+  cli.set_config_path(opts.config_path);
   return cli.run();
-}
\ No newline at end of file
+}
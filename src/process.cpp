@@ -1,4 +1,5 @@
 #include "../include/process.hpp"
+#include "../include/histogram.hpp"
 #include "../include/instruction.hpp"
 #include <algorithm>
 #include <chrono>
@@ -161,6 +162,49 @@ static void unroll_instruction(const Instruction &instr,
   }
 }
 
+/**
+ * Counts instructions as written, FOR headers and their bodies included
+ */
+static uint32_t count_source_instructions(const std::vector<Instruction> &ins) {
+  uint32_t n = 0;
+  for (const auto &inst : ins)
+    n += 1 + (inst.type == InstructionType::FOR ? count_source_instructions(inst.nested) : 0);
+  return n;
+}
+
+/**
+ * Counts the instruction executed in Case 5 into the core's OpcodeProfile,
+ * timing one instruction in sample_period. Scoped so SLEEP's early return
+ * is counted too.
+ */
+namespace {
+class OpcodeSample {
+public:
+  OpcodeSample(OpcodeProfile *profile, InstructionType type)
+      : profile_(profile), op_(static_cast<size_t>(type)) {
+    if (!profile_ || !profile_->sample_period) return;
+    if (profile_->until_sample-- > 0) return;
+    profile_->until_sample = profile_->sample_period - 1;
+    timed_ = true;
+    begin_ = std::chrono::steady_clock::now();
+  }
+  ~OpcodeSample() {
+    if (!profile_) return;
+    relaxed_add(profile_->executed[op_], 1); // this core's worker only
+    if (!timed_) return;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin_).count();
+    relaxed_add(profile_->sampled[op_], 1);
+    relaxed_add(profile_->sampled_ns[op_], static_cast<uint64_t>(ns));
+  }
+
+private:
+  OpcodeProfile *profile_;
+  size_t op_;
+  bool timed_{false};
+  std::chrono::steady_clock::time_point begin_{};
+};
+} // namespace
+
 /**
  * Constructor: preprocesses and unrolls FOR loops
  */
@@ -177,6 +221,7 @@ Process::Process(uint32_t id, const std::string &name,
   }
 
   // Initialize metrics
+  m_source_instructions = count_source_instructions(ins);
   m_metrics.total_instructions = static_cast<uint32_t>(m_instr.size());
   m_metrics.executed_instructions = 0;
   m_metrics.start_time = std::time(nullptr);
@@ -196,17 +241,17 @@ uint32_t Process::id() const { return m_id; }
 std::string Process::name() const { return m_name; }
 
 ProcessState Process::state() {
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
   return m_state;
 }
 
 void Process::set_state(ProcessState s) {
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
   m_state = s;
 }
 
 void Process::set_core_id(uint32_t core) {
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
   m_metrics.core_id = core;
 }
 
@@ -221,12 +266,25 @@ uint32_t Process::get_total_instructions() const {
 uint32_t Process::get_executed_instructions() const {
   return m_metrics.executed_instructions;
 }
+uint32_t Process::get_source_instructions() const {
+  return m_source_instructions;
+}
 uint32_t Process::get_remaining_sleep_ticks() const {
   return m_sleep_remaining;
 }
 
+// Fixed after construction, so no lock is needed
+const std::vector<Instruction> &Process::instructions() const {
+  return m_instr;
+}
+
+void Process::add_stall_ticks(uint32_t ticks) {
+  std::lock_guard<TrackedMutex> lk(m_mutex);
+  m_delay_remaining += ticks;
+}
+
 std::vector<std::string> Process::get_logs() {
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
   return m_logs;
 }
 
@@ -266,12 +324,35 @@ void Process::mark_running() { set_state(ProcessState::RUNNING); }
 void Process::mark_waiting() { set_state(ProcessState::WAITING); }
 void Process::mark_swapped() { set_state(ProcessState::SWAPPED_OUT); }
 void Process::mark_finished(uint32_t tick) {
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
   m_state = ProcessState::FINISHED;
   m_metrics.finished_tick = tick;
   m_metrics.finish_time = std::time(nullptr);
 }
 
+// === Latency Stamps ===
+void Process::stamp_arrival(uint32_t tick) {
+  std::lock_guard<TrackedMutex> lk(m_mutex);
+  m_metrics.created_tick = tick;
+}
+
+bool Process::stamp_dispatch(uint32_t tick) {
+  std::lock_guard<TrackedMutex> lk(m_mutex);
+  if (m_metrics.first_run_tick != UINT32_MAX) return false;
+  m_metrics.first_run_tick = tick;
+  return true;
+}
+
+void Process::stamp_preemption() {
+  std::lock_guard<TrackedMutex> lk(m_mutex);
+  ++m_metrics.preemptions;
+}
+
+ProcessMetrics Process::get_metrics() const {
+  std::lock_guard<TrackedMutex> lk(m_mutex);
+  return m_metrics;
+}
+
 // === Execution Info Helpers ===
 bool Process::has_instructions_remaining() const noexcept {
   return pc < m_instr.size();
@@ -296,7 +377,7 @@ std::string Process::summary_line(bool colorize) const {
   };
 
   std::ostringstream oss;
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
 
   oss << std::left << std::setw(12) << m_name << " "
       << fmt_time(m_metrics.start_time) << "   ";
@@ -320,7 +401,7 @@ std::string Process::summary_line(bool colorize) const {
  * SMI summary with logs (unchanged)
  */
 std::string Process::smi_summary() {
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
   std::ostringstream oss;
   oss << "Process " << m_name << " [" << get_state_string() << "]\n";
   oss << "PC: " << pc << " / " << m_instr.size() << "\n";
@@ -384,9 +465,10 @@ static void set_var_value(const std::string &name, uint16_t v,
  */
 ProcessReturnContext Process::execute_tick(uint32_t global_tick,
                                    uint32_t delays_per_exec,
-                                   uint32_t &consumed_ticks) {
+                                   uint32_t &consumed_ticks,
+                                   OpcodeProfile *profile) {
   consumed_ticks = 1; // default one tick consumed
-  std::lock_guard<std::mutex> lk(m_mutex);
+  std::lock_guard<TrackedMutex> lk(m_mutex);
 
   // --- Case 1: Delay / busy wait ---
   if (m_delay_remaining > 0) {
@@ -436,6 +518,7 @@ ProcessReturnContext Process::execute_tick(uint32_t global_tick,
   // --- Case 5: Execute instruction normally ---
   m_state = ProcessState::RUNNING;
   const Instruction &inst = m_instr[pc];
+  OpcodeSample sample(profile, inst.type);
 
   switch (inst.type) {
   case InstructionType::PRINT: {
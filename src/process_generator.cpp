@@ -1,7 +1,9 @@
 #include "../include/process_generator.hpp"
 #include "../include/instruction.hpp"
 #include "../include/process.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <random>
@@ -76,35 +78,80 @@ static std::string instr_to_string(const Instruction &instr) {
  * Utility: random integer in [min, max]
  *
  * Notes:
- * - Uses a thread-local PRNG (`std::mt19937`) seeded from `std::random_device`.
+ * - Draws from the generator's own PRNG, seeded from `seed` when set so
+ *   that runs are reproducible, otherwise from `std::random_device`.
  * - If `min > max` the values are swapped to avoid undefined behaviour.
- * - This function is safe to call from multiple threads because the RNG is
- *   thread-local.
  *
+ * @param rng The generator's PRNG
  * @param min Lower inclusive bound
  * @param max Upper inclusive bound
  * @return A uniformly distributed random integer in [min, max]
  */
-static uint32_t rand_range(uint32_t min, uint32_t max) {
+static uint32_t rand_range(std::mt19937 &rng, uint32_t min, uint32_t max) {
   // Guard: if min > max, swap to avoid UB
   if (min > max) {
     uint32_t t = min;
     min = max;
     max = t;
   }
-  static thread_local std::mt19937 rng(std::random_device{}());
   std::uniform_int_distribution<uint32_t> dist(min, max);
   return dist(rng);
 }
 
+/**
+ * Draw a priority for a generated process.
+ *
+ * With `priority_weights` set, level `min_priority + i` is chosen with
+ * probability proportional to `priority_weights[i]` (e.g. `8,4,1` makes most
+ * batch jobs low priority). Otherwise the priority is uniform over
+ * [min_priority, max_priority].
+ *
+ * @param rng The generator's PRNG
+ * @param cfg Configuration holding the priority distribution
+ * @return Priority for the new process
+ */
+static uint32_t random_priority(std::mt19937 &rng, const Config &cfg) {
+  if (!cfg.priority_weights.empty()) {
+    std::discrete_distribution<uint32_t> dist(cfg.priority_weights.begin(),
+                                              cfg.priority_weights.end());
+    return cfg.min_priority + dist(rng);
+  }
+  return rand_range(rng, cfg.min_priority, cfg.max_priority);
+}
+
+/**
+ * Instruction sampling for one workload profile
+ *
+ * Built once per generated process. `any` draws from the profile's mix;
+ * `no_for` is the same mix with FOR removed, used at the maximum nesting
+ * depth. An all-zero mix falls back to uniform.
+ */
+struct ProgramShape {
+  explicit ProgramShape(const WorkloadProfile &p) : profile(p) {
+    std::vector<uint32_t> mix = p.mix;
+    mix.resize(6, 0);
+    if (std::all_of(mix.begin(), mix.end(), [](uint32_t w) { return w == 0; }))
+      mix.assign(6, 1);
+    any = std::discrete_distribution<uint32_t>(mix.begin(), mix.end());
+    mix[static_cast<size_t>(InstructionType::FOR)] = 0;
+    if (std::all_of(mix.begin(), mix.end(), [](uint32_t w) { return w == 0; }))
+      mix.assign(5, 1);
+    no_for = std::discrete_distribution<uint32_t>(mix.begin(), mix.end());
+  }
+  const WorkloadProfile &profile;
+  std::discrete_distribution<uint32_t> any;
+  std::discrete_distribution<uint32_t> no_for;
+};
+
 /**
  * Generate a random Instruction instance.
  *
- * The generator can produce any InstructionType including `FOR`. When a
- * `FOR` instruction is generated it will include a repeat count in
- * `args[0]` and a small `nested` vector of child instructions. To prevent
- * runaway nesting the generator accepts a `depth` parameter and will avoid
- * creating `FOR` when `depth >= FOR_MAX_NESTING`.
+ * The type is drawn from the profile's instruction mix. When a `FOR`
+ * instruction is generated it will include a repeat count in `args[0]` and
+ * a small `nested` vector of child instructions, both drawn from the
+ * profile's FOR ranges. To prevent runaway nesting the generator accepts a
+ * `depth` parameter and will avoid creating `FOR` when
+ * `depth >= for_depth` (at most FOR_MAX_NESTING).
  *
  * Behaviour:
  * - PRINT: args[0] = "Hello"
@@ -113,23 +160,17 @@ static uint32_t rand_range(uint32_t min, uint32_t max) {
  * - SLEEP: args = { <ticks> }
  * - FOR: args = { <repeats> }, nested = small list of nested instructions
  *
+ * @param rng The generator's PRNG
+ * @param shape Instruction mix and FOR distributions
  * @param depth Current recursion depth for nested FOR generation (0 =
  * top-level)
  * @return A randomly constructed Instruction
  */
-static Instruction random_instruction(int depth = 0) {
-  InstructionType types[] = {InstructionType::PRINT, InstructionType::DECLARE,
-                             InstructionType::ADD,   InstructionType::SUBTRACT,
-                             InstructionType::SLEEP, InstructionType::FOR};
-  // pick a random index using the actual array size (safer than hardcoding)
-  const uint32_t types_count =
-      static_cast<uint32_t>(sizeof(types) / sizeof(types[0]));
-
-  // Prevent deep FOR nesting. If at or beyond max depth, disallow FOR.
-  InstructionType t;
-  do {
-    t = types[rand_range(0, types_count - 1)];
-  } while (t == InstructionType::FOR && depth >= FOR_MAX_NESTING);
+static Instruction random_instruction(std::mt19937 &rng, ProgramShape &shape,
+                                      uint32_t depth = 0) {
+  const auto &p = shape.profile;
+  InstructionType t = static_cast<InstructionType>(
+      depth >= p.for_depth ? shape.no_for(rng) : shape.any(rng));
 
   Instruction instr;
   instr.type = t;
@@ -140,28 +181,27 @@ static Instruction random_instruction(int depth = 0) {
     break;
   case InstructionType::DECLARE:
     instr.args.push_back("x");
-    instr.args.push_back(std::to_string(rand_range(0, 50)));
+    instr.args.push_back(std::to_string(rand_range(rng, 0, 50)));
     break;
   case InstructionType::ADD:
   case InstructionType::SUBTRACT:
     instr.args.push_back("x");
-    instr.args.push_back(std::to_string(rand_range(0, 20)));
-    instr.args.push_back(std::to_string(rand_range(0, 20)));
+    instr.args.push_back(std::to_string(rand_range(rng, 0, 20)));
+    instr.args.push_back(std::to_string(rand_range(rng, 0, 20)));
     break;
   case InstructionType::SLEEP:
-    instr.args.push_back(std::to_string(rand_range(1, 3)));
+    instr.args.push_back(std::to_string(rand_range(rng, 1, 3)));
     break;
   case InstructionType::FOR: {
-    // FOR(repeats) with nested instructions.
-    // repeats between 1 and 3 to avoid massive expansion when unrolled.
-    uint32_t repeats = rand_range(1, 3);
+    // FOR(repeats) with nested instructions; the default 1-3 repeats of
+    // 1-3 instructions keeps unrolled programs small
+    uint32_t repeats = rand_range(rng, p.for_min_repeats, p.for_max_repeats);
     instr.args.push_back(std::to_string(repeats));
 
-    // Generate a small number of nested instructions (1-3)
-    uint32_t nested_count = rand_range(1, 3);
+    uint32_t nested_count = rand_range(rng, p.for_min_body, p.for_max_body);
     for (uint32_t i = 0; i < nested_count; ++i) {
       // Recursively generate nested instructions, increasing depth
-      Instruction nested = random_instruction(depth + 1);
+      Instruction nested = random_instruction(rng, shape, depth + 1);
       instr.nested.push_back(std::move(nested));
     }
     break;
@@ -172,6 +212,62 @@ static Instruction random_instruction(int depth = 0) {
   return instr;
 }
 
+/**
+ * Draw a program length (top-level instructions) for a profile
+ *
+ * `uniform` is uniform over [min_ins, max_ins]. `pareto` is a Pareto draw
+ * with scale min_ins and tail index pareto_alpha, capped at max_ins, so most
+ * programs are short and a few are very long.
+ *
+ * @param rng The generator's PRNG
+ * @param p Active workload profile
+ * @return Number of top-level instructions to generate
+ */
+static uint32_t random_length(std::mt19937 &rng, const WorkloadProfile &p) {
+  if (p.ins_dist != "pareto") return rand_range(rng, p.min_ins, p.max_ins);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  double u = 1.0 - unit(rng); // (0, 1]
+  double len = std::max<uint32_t>(1, p.min_ins) / std::pow(u, 1.0 / p.pareto_alpha);
+  return static_cast<uint32_t>(std::min<double>(len, p.max_ins));
+}
+
+/**
+ * Draw the gap to the next arrival event, in ticks (0 = same tick)
+ *
+ * - fixed: every `interval` ticks
+ * - poisson: exponential gaps with mean `interval`
+ * - bursty: bursts of `burst_size` events one tick apart, separated by
+ *   exponential gaps with mean `interval * burst_size` (same long-run rate)
+ *
+ * `interval` counts as at least 1 in every mode.
+ *
+ * @param rng The generator's PRNG
+ * @param p Active workload profile
+ * @param burst_left Events left in the current burst (generator state)
+ * @return Ticks until the next arrival event
+ */
+static uint32_t arrival_gap(std::mt19937 &rng, const WorkloadProfile &p,
+                            uint32_t &burst_left) {
+  auto exponential = [&rng](double mean) {
+    if (mean <= 0) return 0u;
+    std::exponential_distribution<double> dist(1.0 / mean);
+    return static_cast<uint32_t>(std::lround(std::min(dist(rng), 1e9)));
+  };
+  // A zero interval (batch-process-freq 0) still means one event per tick
+  // on average; a zero mean would make every gap 0 and on_tick never return
+  uint32_t interval = std::max<uint32_t>(1, p.interval);
+  if (p.arrival == "poisson") return exponential(interval);
+  if (p.arrival == "bursty") {
+    if (burst_left > 0) {
+      --burst_left;
+      return 1;
+    }
+    burst_left = p.burst_size - 1;
+    return exponential(static_cast<double>(interval) * p.burst_size);
+  }
+  return interval;
+}
+
 /**
  * Estimate unrolled size for a single instruction (handles nested FORs)
  *
@@ -234,20 +330,34 @@ static uint32_t estimate_unrolled_size(const std::vector<Instruction> &ins) {
  * @param sched Scheduler that will receive generated processes
  */
 ProcessGenerator::ProcessGenerator(const Config &cfg, Scheduler &sched)
-    : cfg_(cfg), sched_(sched) {}
+    : cfg_(cfg), sched_(sched),
+      rng_(cfg.seed ? cfg.seed : std::random_device{}()),
+      arrival_rng_(cfg.seed ? cfg.seed ^ 0x5bd1e995u : std::random_device{}()) {}
 
-// Public helper used by loop and tests: generate up to target_top_level
+// Public helper used by the CLI and tests: generate up to target_top_level
 // top-level instructions while respecting the configured budget. Returns
 // the generated instructions and writes the estimated unrolled size to
 // estimated_size.
 std::vector<Instruction>
 ProcessGenerator::generate_instructions(uint32_t target_top_level,
                                         uint32_t &estimated_size) {
+  Config cfg = config();
+  std::lock_guard<std::mutex> lock(rng_mtx_);
+  return generate(target_top_level, cfg.max_unrolled_instructions,
+                  active_workload(cfg), estimated_size);
+}
+
+std::vector<Instruction> ProcessGenerator::generate(uint32_t target_top_level,
+                                                    uint32_t budget,
+                                                    const WorkloadProfile &profile,
+                                                    uint32_t &estimated_size) {
   estimated_size = 0;
+  ProgramShape shape(profile);
   std::vector<Instruction> ins;
   ins.reserve(target_top_level);
+  uint32_t redraws = 0; // an oversized first FOR would leave the program empty
   for (uint32_t i = 0; i < target_top_level; ++i) {
-    Instruction instr = random_instruction(0);
+    Instruction instr = random_instruction(rng_, shape, 0);
     uint32_t instr_size = estimate_unrolled_size_for_instr(instr);
 #ifdef DEBUG_GENERATOR
     {
@@ -257,8 +367,11 @@ ProcessGenerator::generate_instructions(uint32_t target_top_level,
       std::clog << dbg.str() << std::endl;
     }
 #endif
-    if (cfg_.max_unrolled_instructions > 0 &&
-        estimated_size + instr_size > cfg_.max_unrolled_instructions) {
+    if (budget > 0 && estimated_size + instr_size > budget) {
+      if (ins.empty() && redraws++ < 64) {
+        --i;
+        continue;
+      }
 #ifdef DEBUG_GENERATOR
       std::ostringstream dbg;
       dbg << "generator: budget exceeded (estimated " << estimated_size
@@ -306,11 +419,11 @@ ProcessGenerator::generate_instructions(uint32_t target_top_level,
 // }
 
 /**
- * Start the process generation thread
+ * Start generating processes
  *
- * Creates and starts a background thread that periodically generates new
- * processes according to the configuration. If already running, this is a
- * no-op.
+ * Installs the scheduler tick hook that submits arrivals (see on_tick) and
+ * starts the background thread that keeps the pool filled. If already
+ * running, this is a no-op.
  *
  * Thread Safety:
  * - Safe to call from any thread
@@ -325,14 +438,15 @@ void ProcessGenerator::start() {
   std::clog << "generator: starting" << std::endl;
 #endif
   thread_ = std::thread(&ProcessGenerator::loop, this);
+  sched_.set_tick_hook([this](uint32_t tick) { on_tick(tick); });
 }
 
 /**
  * Stop the process generation thread
  *
- * Signals the generator thread to stop and waits for it to complete. Safe to
- * call multiple times. After stopping, the generator can be restarted with
- * start().
+ * Removes the tick hook, signals the pool thread to stop and waits for it to
+ * complete. Safe to call multiple times. After stopping, the generator can be
+ * restarted with start(); pooled processes are kept for then.
  *
  * Thread Safety:
  * - Safe to call from any thread
@@ -340,86 +454,214 @@ void ProcessGenerator::start() {
  * - Blocks until generator thread joins
  */
 void ProcessGenerator::stop() {
-  running_.store(false);
+  {
+    // Under pool_mtx_ so the producer cannot miss the wakeup; a stopped
+    // generator leaves the tick hook alone (trace-replay may own it)
+    std::lock_guard<std::mutex> lock(pool_mtx_);
+    if (!running_.exchange(false)) return;
+  }
 #ifdef DEBUG_GENERATOR
   std::clog << "generator: stopping" << std::endl;
 #endif
+  sched_.set_tick_hook(nullptr); // returns once no tick is using the hook
+  pool_cv_.notify_all();
   if (thread_.joinable())
     thread_.join();
 }
 
 /**
- * Main generator thread loop
+ * Apply reloaded tunables
+ *
+ * Only live keys (see `is_live_key`) are copied; the running loop picks them
+ * up before generating its next process.
+ *
+ * @param next Freshly loaded configuration
+ */
+void ProcessGenerator::reload_config(const Config &next) {
+  std::lock_guard<std::mutex> lock(cfg_mtx_);
+  apply_live_keys(cfg_, next);
+}
+
+Config ProcessGenerator::config() {
+  std::lock_guard<std::mutex> lock(cfg_mtx_);
+  return cfg_;
+}
+
+/**
+ * Build one generated process
  *
- * This is the core process generation routine that runs in a background thread.
- * It periodically:
- * 1. Sleeps for batch_process_freq seconds
- * 2. Generates a random set of instructions within budget
- * 3. Creates a new Process with those instructions
- * 4. Submits the Process to the scheduler
+ * Draws the program, priority and deadline from the generator's PRNG, so in
+ * seeded mode the n-th process is the same on every run. The caller holds
+ * rng_mtx_.
+ *
+ * @param cfg Configuration snapshot for this process
+ * @param profile Active workload profile (program length and shape)
+ * @return A new process, not yet submitted
+ */
+std::shared_ptr<Process> ProcessGenerator::make_process(const Config &cfg,
+                                                        const WorkloadProfile &profile) {
+  // Generate process instructions while respecting configured budget
+  uint32_t num_instructions = random_length(rng_, profile);
+  uint32_t estimated_size = 0;
+  std::vector<Instruction> ins = generate(
+      num_instructions, cfg.max_unrolled_instructions, profile, estimated_size);
+
+  // Assign id first (post-increment) and use the same id for the name to
+  // avoid off-by-one mismatch between id and name.
+  uint32_t id = next_id_.fetch_add(1);
+  std::ostringstream name;
+  name << "p" << std::setw(2) << std::setfill('0') << id;
+  auto process = std::make_shared<Process>(id, name.str(), ins);
+  process->priority = random_priority(rng_, cfg);
+  if (cfg.max_deadline > 0)
+    process->deadline = rand_range(rng_, cfg.min_deadline, cfg.max_deadline);
+  process->group_id = sched_.group_id(cfg.generator_group);
+
+#ifdef DEBUG_GENERATOR
+  {
+    std::ostringstream dbg;
+    dbg << "generator: created process id=" << id
+        << " top_level=" << ins.size()
+        << " estimated_unrolled=" << estimated_size;
+    std::clog << dbg.str() << std::endl;
+  }
+#endif
+  return process;
+}
+
+/**
+ * Draw a workload without submitting it
+ *
+ * Same programs and arrival gaps a started generator would produce, so a
+ * seeded config yields the same records every time.
+ *
+ * @param count Number of arrivals
+ * @return Records in arrival order, the first at tick 0
+ */
+std::vector<WorkloadRecord> ProcessGenerator::sample_workload(uint32_t count) {
+  Config cfg = config();
+  std::vector<WorkloadRecord> out;
+  out.reserve(count);
+  uint32_t tick = 0;
+  std::lock_guard<std::mutex> lock(rng_mtx_);
+  while (out.size() < count) {
+    WorkloadProfile profile = active_workload(cfg);
+    for (uint32_t i = 0; i < profile.batch && out.size() < count; ++i) {
+      auto p = make_process(cfg, profile);
+      WorkloadRecord rec;
+      rec.tick = tick;
+      rec.name = p->name();
+      rec.priority = p->priority;
+      rec.deadline = p->deadline;
+      rec.program = std::make_shared<const std::vector<Instruction>>(p->instructions());
+      out.push_back(std::move(rec));
+    }
+    tick += arrival_gap(arrival_rng_, profile, burst_left_);
+  }
+  return out;
+}
+
+// Pool size the producer keeps up: two arrival events' worth, at least 16
+static size_t pool_target(const WorkloadProfile &profile) {
+  return std::max<size_t>(16, 2 * static_cast<size_t>(profile.batch));
+}
+
+/**
+ * Hand over the next n processes, in id order
+ *
+ * Normally a pop from the pool. If the producer is behind, waits for the
+ * process it is generating and makes the rest inline, so arrivals stay on
+ * time at the cost of that tick.
+ *
+ * @param n Processes needed
+ * @param cfg Configuration snapshot
+ * @param profile Active workload profile
+ * @return n processes, not yet submitted
+ */
+std::vector<std::shared_ptr<Process>> ProcessGenerator::take(size_t n, const Config &cfg,
+                                                             const WorkloadProfile &profile) {
+  std::vector<std::shared_ptr<Process>> out;
+  out.reserve(n);
+  auto pop = [&] {
+    std::lock_guard<std::mutex> lock(pool_mtx_);
+    while (out.size() < n && !pool_.empty()) {
+      out.push_back(std::move(pool_.front()));
+      pool_.pop_front();
+    }
+  };
+
+  pop();
+  if (out.size() < n) {
+    std::lock_guard<std::mutex> rng_lock(rng_mtx_);
+    pop();
+    pool_misses_.fetch_add(n - out.size());
+    while (out.size() < n) out.push_back(make_process(cfg, profile));
+  }
+  pool_cv_.notify_one();
+  return out;
+}
+
+/**
+ * Submit one arrival event's processes and draw the gap to the next event
+ *
+ * @param cfg Configuration snapshot
+ * @return Ticks until the next arrival event (0 = same tick)
+ */
+uint32_t ProcessGenerator::arrive(const Config &cfg) {
+  WorkloadProfile profile = active_workload(cfg);
+  for (auto &p : take(profile.batch, cfg, profile))
+    sched_.submit_process(std::move(p));
+  return arrival_gap(arrival_rng_, profile, burst_left_);
+}
+
+/**
+ * Pool producer thread loop
+ *
+ * Keeps pool_target() processes generated ahead of the tick hook so that
+ * generation cost stays out of tick latency. Each process is made and
+ * queued under rng_mtx_, which keeps the pool in id order.
  *
  * Thread Safety:
  * - Runs in dedicated background thread
  * - Uses atomic flag for shutdown coordination
- * - Uses atomic counter for process ID generation
+ * - Sleeps on pool_cv_ while the pool is full
  *
  * Note: This is an internal method called by start(). Do not call directly.
  */
 void ProcessGenerator::loop() {
-  using namespace std::chrono_literals;
   while (running_.load()) {
-    // sleep between process generations
-    std::this_thread::sleep_for(std::chrono::milliseconds(
-        cfg_.batch_process_freq * cfg_.scheduler_tick_delay));
-
-    // Generate process instructions while respecting configured budget
-    uint32_t num_instructions = rand_range(cfg_.min_ins, cfg_.max_ins);
-    uint32_t estimated_size = 0;
-    std::vector<Instruction> ins;
-    ins.reserve(num_instructions);
-    for (uint32_t i = 0; i < num_instructions; ++i) {
-      Instruction instr = random_instruction(0);
-      uint32_t instr_size = estimate_unrolled_size_for_instr(instr);
-#ifdef DEBUG_GENERATOR
-      {
-        std::ostringstream dbg;
-        dbg << "generator: candidate " << instr_to_string(instr)
-            << " -> estimated_size=" << instr_size;
-        std::clog << dbg.str() << std::endl;
-      }
-#endif
-      if (cfg_.max_unrolled_instructions > 0 &&
-          estimated_size + instr_size > cfg_.max_unrolled_instructions) {
-        // exceeding budget: stop adding more top-level instructions
-#ifdef DEBUG_GENERATOR
-        std::ostringstream dbg;
-        dbg << "generator: budget exceeded (estimated " << estimated_size
-            << ", instr would add " << instr_size << ") - stopping";
-        std::clog << dbg.str() << std::endl;
-#endif
-        break;
-      }
-      estimated_size += instr_size;
-      ins.push_back(std::move(instr));
-    }
-
-    // Assign id first (post-increment) and use the same id for the name to
-    // avoid off-by-one mismatch between id and name.
-    uint32_t id = next_id_.fetch_add(1);
-    std::ostringstream name;
-    name << "p" << std::setw(2) << std::setfill('0') << id;
-    auto process = std::make_shared<Process>(id, name.str(), ins);
-
-#ifdef DEBUG_GENERATOR
+    Config cfg = config(); // picks up reload-config between processes
+    WorkloadProfile profile = active_workload(cfg);
     {
-      std::ostringstream dbg;
-      dbg << "generator: created process id=" << id
-          << " top_level=" << ins.size()
-          << " estimated_unrolled=" << estimated_size;
-      std::clog << dbg.str() << std::endl;
+      std::unique_lock<std::mutex> lock(pool_mtx_);
+      pool_cv_.wait(lock, [&] { return !running_.load() || pool_.size() < pool_target(profile); });
     }
-#endif
+    if (!running_.load()) break;
+
+    std::lock_guard<std::mutex> rng_lock(rng_mtx_);
+    auto process = make_process(cfg, profile);
+    std::lock_guard<std::mutex> lock(pool_mtx_);
+    pool_.push_back(std::move(process));
+  }
+}
 
-    sched_.submit_process(process);
+/**
+ * Arrival events on the scheduler clock
+ *
+ * Runs on the scheduler thread from the tick hook, before admission, so
+ * arrivals are exact in emulated time: they pause with the scheduler and
+ * do not depend on the tick delay. With a seed the arrival ticks are fixed
+ * by the seed and the config alone.
+ *
+ * @param tick The tick being scheduled
+ */
+void ProcessGenerator::on_tick(uint32_t /*tick*/) {
+  if (ticks_to_next_ > 1) {
+    --ticks_to_next_;
+    return;
   }
+  Config cfg = config();
+  do {
+    ticks_to_next_ = arrive(cfg);
+  } while (ticks_to_next_ == 0);
 }
@@ -20,33 +20,57 @@ static std::string now_string() {
   return std::string(buf);
 }
 
-// derive utilization by counting idle lines from the scheduler state snapshot
-static void derive_utilization(Scheduler &sched, int &used, int &total) {
+static std::string percent(double fraction) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1) << 100.0 * fraction << "%";
+  return oss.str();
+}
+
+// Reads the scheduler's per-core counters; O(cores), no snapshot parsing
+static std::string utilization_section(Scheduler &sched) {
+  UtilizationReport u = sched.utilization();
+  int used = static_cast<int>(u.busy_now);
+  int total = static_cast<int>(u.online);
+  int available = std::max(0, total - used);
+  int now_percent = (total > 0) ? (used * 100 / total) : 0;
 
-  total = static_cast<int>(sched.get_cpu_count());
-  std::string snap = sched.get_sched_snapshots();
-  int idle = 0;
-  std::istringstream iss(snap);
+  std::ostringstream oss;
+  oss << "CPU utilization: " << now_percent << "%\n"
+      << "Cores used: " << used << "\n"
+      << "Cores available: " << available << "\n";
 
-  for (std::string line; std::getline(iss, line); ) {
-    if (line.find("IDLE") != std::string::npos) ++idle;
+  oss << "Utilization";
+  for (size_t i = 0; i < u.windows.size(); ++i) {
+    const UtilizationWindow &w = u.windows[i];
+    oss << (i ? ", " : " ") << w.seconds << "s " << percent(w.fraction());
+    if (w.covered_seconds + 0.5 < w.seconds)
+      oss << " (" << std::fixed << std::setprecision(1) << w.covered_seconds << "s so far)";
   }
+  oss << "\n";
 
-  used = std::max(0, total - idle);
+  oss << "Per core:";
+  for (size_t cpu_id = 0; cpu_id < u.cores.size(); ++cpu_id) {
+    const CoreUtilization &c = u.cores[cpu_id];
+    uint64_t ticks = c.busy_ticks + c.idle_ticks;
+    oss << " " << cpu_id << "=";
+    if (!c.online) oss << "off";
+    else oss << percent(ticks ? static_cast<double>(c.busy_ticks) / ticks : 0.0);
+  }
+  oss << "\n\n";
+  return oss.str();
 }
 
 std::string Reporter::build_report() {
-  
-  int used=0, total=0;
-  derive_utilization(sched_, used, total);
-  int available = std::max(0, total - used);
-  int percent = (total>0) ? (used*100/total) : 0;
-
   std::ostringstream oss;
-  oss << "CPU utilization: " << percent << "%\n"
-      << "Cores used: " << used << "\n"
-      << "Cores available: " << available << "\n\n"
-      << sched_.snapshot() << "\n";
+  oss << utilization_section(sched_);
+
+  std::string deadlines = sched_.deadline_report();
+  if (!deadlines.empty()) oss << deadlines << "\n";
+
+  std::string latency = sched_.latency_report();
+  if (!latency.empty()) oss << latency << "\n";
+
+  oss << sched_.snapshot() << "\n";
   return oss.str();
 }
 
@@ -0,0 +1,270 @@
+#include "../include/sched_trace.hpp"
+#include "../include/process.hpp"
+#include "../include/scheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+// Layout: "CSTR", version byte, header varints, then per event
+//   kind (1 byte), tick delta, pid, cpu            (varints)
+// with ARRIVAL replacing cpu by
+//   name, priority, deadline, deadline_tick, group, program
+// Strings are a length varint plus bytes; an instruction is its type byte,
+// argument strings and nested instructions, each list prefixed by its count.
+
+static const char kMagic[4] = {'C', 'S', 'T', 'R'};
+static constexpr uint8_t kVersion = 1;
+static constexpr uint32_t kReplaySlackTicks = 10000; // give up this long past the last event
+
+// === Encoding ===
+
+static void put_varint(std::ostream &out, uint64_t v) {
+  while (v >= 0x80) {
+    out.put(static_cast<char>((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+  out.put(static_cast<char>(v));
+}
+
+static void put_string(std::ostream &out, const std::string &s) {
+  put_varint(out, s.size());
+  out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+static void put_instructions(std::ostream &out, const std::vector<Instruction> &ins) {
+  put_varint(out, ins.size());
+  for (const auto &i : ins) {
+    out.put(static_cast<char>(i.type));
+    put_varint(out, i.args.size());
+    for (const auto &a : i.args) put_string(out, a);
+    put_instructions(out, i.nested);
+  }
+}
+
+// Bounds-checked cursor over the whole file; any overrun marks it bad
+struct Cursor {
+  const std::string &buf;
+  size_t pos{0};
+  bool bad{false};
+
+  uint8_t byte() {
+    if (pos >= buf.size()) { bad = true; return 0; }
+    return static_cast<uint8_t>(buf[pos++]);
+  }
+  uint64_t varint() {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64 && !bad; shift += 7) {
+      uint8_t b = byte();
+      v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80)) return v;
+    }
+    bad = true;
+    return 0;
+  }
+  std::string string() {
+    uint64_t n = varint();
+    if (bad || n > buf.size() - pos) { bad = true; return {}; }
+    std::string s = buf.substr(pos, n);
+    pos += n;
+    return s;
+  }
+  std::vector<Instruction> instructions() {
+    std::vector<Instruction> ins(static_cast<size_t>(std::min<uint64_t>(varint(), buf.size() - pos)));
+    for (auto &i : ins) {
+      if (bad) break;
+      i.type = static_cast<InstructionType>(byte());
+      i.args.resize(static_cast<size_t>(std::min<uint64_t>(varint(), buf.size() - pos)));
+      for (auto &a : i.args) a = string();
+      i.nested = instructions();
+    }
+    return ins;
+  }
+};
+
+// === Recording ===
+
+bool SchedTraceWriter::open(const std::string &path, const Config &cfg) {
+  out_.open(path, std::ios::binary | std::ios::trunc);
+  if (!out_) return false;
+  out_.write(kMagic, sizeof(kMagic));
+  out_.put(static_cast<char>(kVersion));
+  put_varint(out_, cfg.num_cpu);
+  put_varint(out_, cfg.scheduler);
+  put_varint(out_, cfg.quantum_cycles);
+  put_varint(out_, cfg.delay_per_exec);
+  put_varint(out_, cfg.seed);
+  return static_cast<bool>(out_);
+}
+
+void SchedTraceWriter::record(TraceKind kind, uint32_t tick, const Process &p, uint32_t cpu) {
+  out_.put(static_cast<char>(kind));
+  put_varint(out_, tick - last_tick_);
+  put_varint(out_, p.id());
+  last_tick_ = tick;
+  ++events_;
+
+  if (kind != TraceKind::ARRIVAL) {
+    put_varint(out_, cpu);
+    return;
+  }
+  put_string(out_, p.name());
+  put_varint(out_, p.priority);
+  put_varint(out_, p.deadline);
+  put_varint(out_, p.deadline_tick);
+  put_varint(out_, p.group_id);
+  put_instructions(out_, p.instructions());
+}
+
+void SchedTraceWriter::close() {
+  if (out_.is_open()) out_.close();
+}
+
+// === Reading ===
+
+bool read_sched_trace(const std::string &path, SchedTrace &out, std::string &error) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  const std::string buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (buf.size() < 5 || buf.compare(0, 4, kMagic, 4) != 0 || static_cast<uint8_t>(buf[4]) != kVersion) {
+    error = path + " is not a scheduling trace (version " + std::to_string(kVersion) + ")";
+    return false;
+  }
+
+  Cursor c{buf, 5};
+  out.header.num_cpu = static_cast<uint32_t>(c.varint());
+  out.header.scheduler = static_cast<SchedulingPolicy>(c.varint());
+  out.header.quantum_cycles = static_cast<uint32_t>(c.varint());
+  out.header.delay_per_exec = static_cast<uint32_t>(c.varint());
+  out.header.seed = static_cast<uint32_t>(c.varint());
+
+  uint32_t tick = 0;
+  while (!c.bad && c.pos < buf.size()) {
+    TraceEvent e;
+    e.kind = static_cast<TraceKind>(c.byte());
+    tick += static_cast<uint32_t>(c.varint());
+    e.tick = tick;
+    e.pid = static_cast<uint32_t>(c.varint());
+    if (e.kind == TraceKind::ARRIVAL) {
+      TraceArrival a;
+      a.pid = e.pid;
+      a.name = c.string();
+      a.priority = static_cast<uint32_t>(c.varint());
+      a.deadline = static_cast<uint32_t>(c.varint());
+      a.deadline_tick = static_cast<uint32_t>(c.varint());
+      a.group_id = static_cast<uint32_t>(c.varint());
+      a.program = c.instructions();
+      out.arrivals.push_back(std::move(a));
+    } else {
+      e.cpu = static_cast<uint32_t>(c.varint());
+    }
+    if (!c.bad) out.events.push_back(e);
+  }
+  if (c.bad) {
+    error = path + " is truncated after " + std::to_string(out.events.size()) + " events";
+    return false;
+  }
+  return true;
+}
+
+std::string describe(const TraceEvent &e) {
+  static const char *const kNames[] = {"ARRIVAL", "DISPATCH", "PREEMPT", "FINISH"};
+  std::ostringstream oss;
+  oss << kNames[static_cast<size_t>(e.kind) % 4] << " pid " << e.pid;
+  if (e.kind != TraceKind::ARRIVAL) oss << " on CPU " << e.cpu;
+  oss << " at tick " << e.tick;
+  return oss.str();
+}
+
+// === Replay ===
+
+ReplayResult replay_sched_trace(const std::string &path, const Config &base) {
+  ReplayResult r;
+  SchedTrace trace;
+  if (!read_sched_trace(path, trace, r.error)) return r;
+  r.events = trace.events.size();
+
+  Config cfg = base;
+  cfg.num_cpu = trace.header.num_cpu;
+  cfg.scheduler = trace.header.scheduler;
+  cfg.quantum_cycles = trace.header.quantum_cycles;
+  cfg.delay_per_exec = trace.header.delay_per_exec;
+  cfg.seed = trace.header.seed;
+  cfg.scheduler_tick_delay = 0;
+  cfg.snapshot_cooldown = UINT32_MAX;
+  cfg.record_trace.clear();
+  cfg.pin_scheduler = -1;
+  cfg.pin_workers = "none";
+
+  std::vector<uint32_t> arrival_ticks;
+  for (const auto &e : trace.events)
+    if (e.kind == TraceKind::ARRIVAL) arrival_ticks.push_back(e.tick);
+
+  Scheduler sched(cfg);
+  size_t next_arrival = 0;                   // scheduler thread only
+  std::atomic<size_t> matched{0};
+  std::atomic<bool> diverged{false};
+
+  // Recorded arrivals were admitted at their tick; submitting them from the
+  // tick hook (which runs just before admission) reproduces that
+  sched.set_tick_hook([&](uint32_t tick) {
+    while (next_arrival < arrival_ticks.size() && arrival_ticks[next_arrival] <= tick) {
+      const auto &a = trace.arrivals[next_arrival++];
+      auto p = std::make_shared<Process>(a.pid, a.name, a.program);
+      p->priority = a.priority;
+      p->deadline = a.deadline;
+      p->deadline_tick = a.deadline_tick;
+      p->group_id = a.group_id;
+      sched.submit_process(p);
+    }
+  });
+  sched.set_trace_hook([&](TraceKind kind, uint32_t tick, const Process &p, uint32_t cpu) {
+    size_t i = matched.load(std::memory_order_relaxed);
+    if (diverged.load(std::memory_order_relaxed) || i >= trace.events.size()) return;
+    TraceEvent got{kind, tick, p.id(), kind == TraceKind::ARRIVAL ? 0 : cpu};
+    if (got == trace.events[i]) {
+      matched.store(i + 1, std::memory_order_release);
+      return;
+    }
+    r.divergence = "event " + std::to_string(i) + ": recorded " + describe(trace.events[i]) +
+                   ", replay " + describe(got);
+    diverged.store(true, std::memory_order_release);
+  });
+
+  const uint32_t give_up = (trace.events.empty() ? 0 : trace.events.back().tick) + kReplaySlackTicks;
+  auto t0 = std::chrono::steady_clock::now();
+  uint32_t first_tick = sched.current_tick();
+  sched.start();
+  while (!diverged.load(std::memory_order_acquire) && matched.load() < trace.events.size() &&
+         sched.current_tick() < give_up)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  sched.stop();
+
+  r.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  r.ticks = sched.current_tick() - first_tick;
+  r.matched = matched.load();
+  if (!diverged.load() && r.matched < r.events)
+    r.divergence = "event " + std::to_string(r.matched) + ": recorded " + describe(trace.events[r.matched]) +
+                   ", replay never made it (ran to tick " + std::to_string(sched.current_tick()) + ")";
+  r.ok = r.divergence.empty();
+  return r;
+}
+
+std::string replay_report(const ReplayResult &r) {
+  std::ostringstream oss;
+  if (!r.error.empty()) {
+    oss << "Replay failed: " << r.error << "\n";
+    return oss.str();
+  }
+  oss << std::fixed << std::setprecision(1);
+  if (r.ok)
+    oss << "Replay matched: " << r.events << " events over " << r.ticks << " ticks in " << r.wall_ms << " ms\n";
+  else
+    oss << "Replay diverged after " << r.matched << "/" << r.events << " events at " << r.divergence << "\n";
+  return oss.str();
+}
@@ -9,6 +9,8 @@
 #include <thread>
 #include <chrono>
 #include <sstream>
+#include <iomanip>
+#include <algorithm>
 
 #define DEBUG_SCHEDULER false
 
@@ -20,14 +22,21 @@
 
 Scheduler::Scheduler(const Config &cfg)
     : cfg_(cfg),
-      busy_ticks_per_cpu_(cfg.num_cpu),
-      job_queue_(Channel<std::shared_ptr<Process>>()),
-      ready_queue_(cfg.scheduler),
-      blocked_queue_(Channel<std::shared_ptr<Process>>()),
-      swapped_queue_(Channel<std::shared_ptr<Process>>()),
+      log_queue("channel.log"),
+      job_queue_("channel.job_queue"),
+      ready_queue_(cfg.scheduler, cfg.aging_ticks),
+      blocked_queue_("channel.blocked"),
+      swapped_queue_("channel.swapped"),
       finished_(FinishedMap())
 {
+  this->cpu_capacity_ = std::max(cfg.num_cpu, cfg.max_cpu);
   initialize_vectors();
+  initialize_groups();
+  initialize_latency();
+  initialize_profile();
+  initialize_opcode_profile();
+  if (cfg.timeline_events > 0)
+    this->timeline_ = std::make_unique<Timeline>(cpu_capacity_, cfg.timeline_events);
   this->tick_.store(1);
 }
 
@@ -43,22 +52,49 @@ void Scheduler::start()
     return;
 
   sched_running_.store(true);
+  started_at_ = std::chrono::steady_clock::now();
+  phase_started_at_ = generation_started_at_ = started_at_;
+  current_phase_ = TimelinePhase::IDLE;
   std::cout << "Scheduler started.\n";
 
   // All CPU Threads + Scheduler Thread synchronize here
 
-  this->tick_sync_barrier_ = std::make_unique<std::barrier<>>(
-      static_cast<std::ptrdiff_t>(cfg_.num_cpu + 1));
+  this->tick_sync_barrier_ = std::make_unique<TickBarrier>(cfg_.num_cpu + 1);
 
-  // Start CPU workers
+  // Start CPU workers; slots above num_cpu stay offline until cpu-online
+  cpu_workers_.assign(cpu_capacity_, nullptr);
   for (uint32_t i = 0; i < cfg_.num_cpu; ++i)
   {
-    cpu_workers_.emplace_back(std::make_unique<CPUWorker>(i, *this));
-    cpu_workers_.back()->start();
+    cpu_workers_[i] = std::make_shared<CPUWorker>(i, *this);
+    cpu_workers_[i]->start();
   }
 
   // Start scheduler tick controller
   sched_thread_ = std::thread(&Scheduler::tick_loop, this);
+
+  apply_pinning();
+}
+
+// Pins the scheduler and worker threads per pin-scheduler / pin-workers and
+// records what the host accepted
+void Scheduler::apply_pinning()
+{
+  PinLayout plan = pinning_plan();
+  pinned_ = plan;
+
+  if (plan.scheduler_cpu >= 0 && !pin_thread(sched_thread_, plan.scheduler_cpu))
+    pinned_.scheduler_cpu = -1;
+  for (uint32_t i = 0; i < cpu_workers_.size() && i < plan.worker_cpus.size(); ++i)
+    if (plan.worker_cpus[i] >= 0 && (!cpu_workers_[i] || !cpu_workers_[i]->pin(plan.worker_cpus[i])))
+      pinned_.worker_cpus[i] = -1;
+}
+
+// Layout over every core slot, so cores onlined later get their host CPU too
+PinLayout Scheduler::pinning_plan() const
+{
+  Config all = this->cfg_;
+  all.num_cpu = cpu_capacity_;
+  return plan_pinning(all, host_cpus());
 }
 
 void Scheduler::stop(){
@@ -66,23 +102,28 @@ void Scheduler::stop(){
     std::cout << "Scheduler stopping...\n";
   #endif
 
-  sched_running_.store(false);
-  paused_.store(false);
+  {
+    std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
+    sched_running_.store(false);
+    paused_.store(false);
+  }
   pause_cv_.notify_all();
 
-  for (auto &worker : cpu_workers_) worker->stop();
-
-  if (tick_sync_barrier_) tick_sync_barrier_->arrive_and_drop();
-
-  for (auto &worker : cpu_workers_) worker->join();
-
+  // tick_loop finishes its current tick, then releases the workers through
+  // one last barrier phase (see end of tick_loop). Dropping barrier slots
+  // from this thread instead would race with workers still inside a tick.
   if (sched_thread_.joinable()) sched_thread_.join();
+
+  for (auto &worker : cpu_workers_) if (worker) worker->join();
+  if (recorder_) recorder_->close();
 }
 
 // === Long-Term Scheduling API ===
 
 void Scheduler::submit_process(std::shared_ptr<Process> p)
 {
+  // Replayed processes arrive with the deadline they were recorded with
+  if (p->deadline > 0 && p->deadline_tick == 0) p->deadline_tick = this->tick_.load() + p->deadline;
   p->set_state(ProcessState::NEW);
   this->job_queue_.send(p);
 }
@@ -91,46 +132,139 @@ void Scheduler::long_term_admission()
 {
   while (!this->job_queue_.isEmpty()){
     auto p = this->job_queue_.receive();
-    p->set_state(ProcessState::READY);
-    this->ready_queue_.send(p);
+    latency_arrival(*p);
+    opcode_arrival(*p);
+    trace(TraceKind::ARRIVAL, *p);
+    feed(FeedEvent::ARRIVAL, *p);
+    if (admit_deadline(p)) enqueue_ready(p);
   }
 }
 
+// Admission control for deadline-tagged processes. The fastest possible
+// finish is every remaining instruction back to back, each costing one tick
+// plus delay_per_exec. If even that lands after the deadline the process can
+// never meet it, and it is flagged or rejected per deadline-admission.
+bool Scheduler::admit_deadline(const std::shared_ptr<Process> &p)
+{
+  if (p->deadline_tick == 0 || this->cfg_.deadline_admission == DeadlineAdmission::NONE) return true;
+
+  uint64_t remaining = p->get_total_instructions() - p->get_executed_instructions();
+  uint64_t earliest_finish = this->tick_.load() + remaining * (1 + this->cfg_.delay_per_exec);
+  if (earliest_finish <= p->deadline_tick) return true;
+
+  std::lock_guard<std::mutex> lock(deadline_mtx_);
+  if (this->cfg_.deadline_admission == DeadlineAdmission::REJECT) {
+    deadline_stats_.rejected++;
+    rejected_.push_back(p);
+    return false;
+  }
+  deadline_stats_.flagged++;
+  p->deadline_flagged = true;
+  return true;
+}
+
+// Every path into the ready queue goes through here so that `ready_tick`
+// (used for aging and waiting-time accounting) is stamped consistently.
+void Scheduler::enqueue_ready(std::shared_ptr<Process> p)
+{
+  p->set_state(ProcessState::READY);
+  p->ready_tick = this->tick_.load();
+
+  if (this->cfg_.scheduler == MLFQ) {
+    if (p->mlfq_epoch != mlfq_epoch_) { // missed a boost while new/sleeping
+      p->mlfq_level = 0;
+      p->mlfq_epoch = mlfq_epoch_;
+    }
+    mlfq_level_len_[p->mlfq_level].fetch_add(1);
+  }
+
+  if (groups_enabled_) groups_[p->group_id].ready.fetch_add(1);
+
+  // New and waking processes start at the current floor so they cannot
+  // monopolise the CPU with a vruntime far behind everyone else's
+  if (this->cfg_.scheduler == CFS)
+    p->vruntime = std::max(p->vruntime, min_vruntime_.load());
+
+  this->ready_queue_.send(p);
+}
+
 // === Paging & Swapping (Medium-term scheduler) ===
 
 // === Short-Term Scheduling API ===
 
 std::shared_ptr<Process> Scheduler::dispatch_to_cpu(uint32_t cpu_id)
 {
-  std::lock_guard<std::mutex> lock(short_term_mtx_);
+  std::lock_guard<TrackedMutex> lock(short_term_mtx_);
 
+  if (!online_[cpu_id]) return nullptr;
   if (this->ready_queue_.isEmpty() && !running_[cpu_id]){
     return nullptr;
   } else if (running_[cpu_id]) {
     return running_[cpu_id];
   }
 
-  // Assign Current Process to Scheduler Internal States
-  auto p = this->ready_queue_.receiveNext();
+  uint32_t now = this->tick_.load();
+
+  // With affinity on, only the head of the queue is scanned (one entry per
+  // core is enough to find work this core is allowed to take); processes
+  // still waiting for their previous core stay queued
+  auto eligible = [this, cpu_id, now](const Process &c) { return affinity_eligible(c, cpu_id, now); };
+  const size_t scan_limit = 2 * static_cast<size_t>(this->online_cpus_.load());
+
+  // Take the next ready process whose group still has CPU budget; the
+  // others are parked in their group until capacity frees up
+  std::shared_ptr<Process> p;
+  while (!p && !this->ready_queue_.isEmpty()){
+    auto candidate = this->cfg_.affinity ? this->ready_queue_.receiveFirst(eligible, scan_limit)
+                                         : this->ready_queue_.receiveNext();
+    if (!candidate) break;
+    if (this->cfg_.scheduler == MLFQ) mlfq_level_len_[candidate->mlfq_level].fetch_sub(1);
+    if (groups_enabled_ && !group_admit(candidate)) continue;
+    p = candidate;
+  }
+  if (!p) return nullptr;
 
+  // Assign Current Process to Scheduler Internal States
   p->set_state(ProcessState::RUNNING);
+  affinity_account(*p, cpu_id);
   p->cpu_id = cpu_id;
+  p->set_core_id(cpu_id);
   running_[cpu_id] = p;
-  p->last_active_tick = this->tick_.load();
+  p->ticks_waited += now - p->ready_tick;
+  dispatch_latency_.record(now - p->ready_tick);
+  latency_dispatch(*p, now);
+  trace(TraceKind::DISPATCH, *p, cpu_id);
+  mark(TimelineKind::DISPATCH, *p, cpu_id);
+  p->last_active_tick = now;
+  cpu_quantum_remaining_[cpu_id] = quantum_for(*p) - 1;
 
   return p;
 }
 
 void Scheduler::release_cpu_interrupt(uint32_t cpu_id, std::shared_ptr<Process> p, ProcessReturnContext context)
 {
-  std::lock_guard<std::mutex> lock(short_term_mtx_);
+  release_cpu(cpu_id, p, context, this->tick_.load());
+}
+
+// `tick` is the tick the process yielded in; worker events are applied one
+// tick later
+void Scheduler::release_cpu(uint32_t cpu_id, std::shared_ptr<Process> p,
+                            const ProcessReturnContext &context, uint32_t tick)
+{
+  std::lock_guard<TrackedMutex> lock(short_term_mtx_);
   if (p->is_finished()){
     p->set_state(ProcessState::FINISHED);
     running_[cpu_id] = nullptr;
-    finished_.insert(p, tick_ + 1);
+    latency_finish(*p, tick + 1);
+    trace(TraceKind::FINISH, *p, cpu_id);
+    mark(TimelineKind::FINISH, *p, cpu_id);
+    feed(FeedEvent::FINISH, *p);
+    finished_.insert(p, tick + 1);
+    if (p->deadline_tick) record_deadline_outcome(p, tick);
   } else if (p->is_waiting()) {
     p->set_state(ProcessState::WAITING);
     running_[cpu_id] = nullptr;
+    mark(TimelineKind::SLEEP, *p, cpu_id);
     TimerEntry t;
     t.process = p;
     uint64_t duration = 0;
@@ -140,34 +274,94 @@ void Scheduler::release_cpu_interrupt(uint32_t cpu_id, std::shared_ptr<Process>
     } catch (...) {
         duration = 0;
     }
-    t.wake_tick = duration + tick_;
+    t.wake_tick = duration + tick;
     sleep_queue_.push(t);
+  } else if (context.state == ProcessState::READY) {
+    // Preempted (quantum expiry or higher priority arrival): back to ready
+    running_[cpu_id] = nullptr;
+    latency_preemption(*p);
+    trace(TraceKind::PREEMPT, *p, cpu_id);
+    mark(TimelineKind::PREEMPT, *p, cpu_id);
+    enqueue_ready(p);
+  }
+
+  if (groups_enabled_ && !running_[cpu_id]) group_released(p);
+}
+
+// === CPU Worker API ===
+// Workers never touch running_ or short_term_mtx_. Between the last barrier
+// of one tick and the first barrier of the next only the scheduler thread
+// runs; it applies the events workers posted and publishes every core's
+// process. Between the first and second barrier each worker only reads its
+// own mailbox and executes that process.
+
+Process *Scheduler::assigned_process(uint32_t cpu_id) const
+{
+  return mailboxes_[cpu_id].assigned.load(std::memory_order_acquire);
+}
+
+void Scheduler::post_core_event(uint32_t cpu_id, ProcessReturnContext context)
+{
+  // Drained every tick and a worker posts at most once per tick, so the
+  // ring cannot fill up
+  bool posted = mailboxes_[cpu_id].events.tryPush({std::move(context), this->tick_.load()});
+  assert(posted);
+  (void)posted;
+}
+
+void Scheduler::account_core_tick(uint32_t cpu_id, bool busy)
+{
+  // Worker cpu_id is the only writer of its counters
+  relaxed_add(busy ? mailboxes_[cpu_id].busy_ticks : mailboxes_[cpu_id].idle_ticks, 1);
+}
+
+void Scheduler::drain_core_events()
+{
+  for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
+    CoreEvent event;
+    while (mailboxes_[cpu_id].events.tryPop(event)){
+      if (running_[cpu_id]) release_cpu(cpu_id, running_[cpu_id], event.context, event.tick);
+    }
+  }
+}
+
+void Scheduler::publish_assignments()
+{
+  for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
+    mailboxes_[cpu_id].assigned.store(running_[cpu_id].get(), std::memory_order_release);
   }
 }
 
 
 
 void Scheduler::short_term_dispatch(){ 
-  for (uint32_t cpu_id = 0; cpu_id < this->cfg_.num_cpu; ++cpu_id){
+  for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
 
     if (!running_[cpu_id]) dispatch_to_cpu(cpu_id);
   }
+  if (!group_fill_idle()) return;
+  for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id)
+    if (!running_[cpu_id]) dispatch_to_cpu(cpu_id);
 }
 
 // === Pre and Post Schedulers ===
 
 void Scheduler::preemption_check()
 {
+  group_accounting();
+
   switch (this->cfg_.scheduler)
   {
   case RR:
     #if DEBUG_SCHEDULER
       std::cout << "Preemption Check" << "\n";
     #endif
-    for (uint32_t cpu_id = 0; cpu_id < this->cfg_.num_cpu; ++cpu_id){
+    for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
       
       if (!running_[cpu_id]) {
+        #if DEBUG_SCHEDULER
         std::cout << "  CPU ID: " << cpu_id << " IDLE\n";
+        #endif
         continue;
       }
 
@@ -184,23 +378,196 @@ void Scheduler::preemption_check()
       ProcessReturnContext interrupt = {ProcessState::READY, {}};
       release_cpu_interrupt(cpu_id, running_[cpu_id], interrupt);
       dispatch_to_cpu(cpu_id);
-      cpu_quantum_remaining_[cpu_id] = this->cfg_.quantum_cycles - 1;
     }
     break;
-  case FCFS:
-  case PRIORITY: // No preemption in FCFS or Priority Scheduling
+  case PRIORITY:
+    if (this->cfg_.priority_preempt) priority_preemption();
+    break;
+  case CFS:
+    cfs_preemption();
+    break;
+  case EDF:
+    edf_preemption();
+    break;
+  case MLFQ:
+    if (this->cfg_.mlfq_boost_ticks > 0 && this->tick_ % this->cfg_.mlfq_boost_ticks == 0)
+      mlfq_boost();
+    mlfq_preemption();
+    break;
+  case FCFS: // No preemption in FCFS
     break;
   default:
     break;
   }
 }
 
+// Preempts while the best ready process outranks the lowest-priority running
+// one. Ready processes are compared by aged (effective) priority; a running
+// process keeps its base priority since aging restarts when it is dispatched.
+// Each round raises the minimum running priority, so this ends after at most
+// cpu_capacity_ rounds.
+void Scheduler::priority_preemption()
+{
+  uint32_t now = this->tick_.load();
+
+  for (uint32_t round = 0; round < this->cpu_capacity_; ++round){
+    auto best = ready_queue_.peekNext();
+    if (!best) return;
+
+    int64_t victim = -1;
+    for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
+      if (!online_[cpu_id]) continue;
+      if (!running_[cpu_id]) return; // an idle core will pick it up in dispatch
+      if (victim < 0 || running_[cpu_id]->priority < running_[victim]->priority)
+        victim = cpu_id;
+    }
+
+    if (victim < 0 || effective_priority(*best, now, this->cfg_.aging_ticks) <= running_[victim]->priority)
+      return;
+
+    #if DEBUG_SCHEDULER
+      std::cout << "  Preempting PID=" << running_[victim]->id() << " for PID=" << best->id() << "\n";
+    #endif
+    ProcessReturnContext interrupt = {ProcessState::READY, {}};
+    release_cpu_interrupt(victim, running_[victim], interrupt);
+    dispatch_to_cpu(victim);
+  }
+}
+
+void Scheduler::mlfq_preemption()
+{
+  ProcessReturnContext interrupt = {ProcessState::READY, {}};
+
+  // Quantum expired: demote one level and go to the back of the new level
+  for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
+    auto p = running_[cpu_id];
+    if (!p) continue;
+
+    if (cpu_quantum_remaining_[cpu_id] > 0){
+      cpu_quantum_remaining_[cpu_id]--;
+      continue;
+    }
+
+    if (p->mlfq_level + 1 < this->cfg_.mlfq_levels) p->mlfq_level++;
+    release_cpu_interrupt(cpu_id, p, interrupt);
+    dispatch_to_cpu(cpu_id);
+  }
+
+  // A ready process on a higher level displaces the lowest-level running one.
+  // The displaced process keeps its level since it did not use up its quantum.
+  for (uint32_t round = 0; round < this->cpu_capacity_; ++round){
+    auto best = ready_queue_.peekNext();
+    if (!best) return;
+
+    int64_t victim = -1;
+    for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
+      if (!online_[cpu_id]) continue;
+      if (!running_[cpu_id]) return; // an idle core will pick it up in dispatch
+      if (victim < 0 || running_[cpu_id]->mlfq_level > running_[victim]->mlfq_level)
+        victim = cpu_id;
+    }
+
+    if (victim < 0 || best->mlfq_level >= running_[victim]->mlfq_level) return;
+
+    release_cpu_interrupt(victim, running_[victim], interrupt);
+    dispatch_to_cpu(victim);
+  }
+}
+
+// Runs once per tick before workers execute. Every running process executed
+// one instruction last tick and is charged a priority-weighted vruntime delta.
+// Once it has run cfs_min_granularity ticks it yields to the leftmost (smallest
+// vruntime) ready process if that one is behind it. Picking the leftmost is
+// O(log n) in the ordered ready set.
+void Scheduler::cfs_preemption()
+{
+  ProcessReturnContext interrupt = {ProcessState::READY, {}};
+  uint64_t floor = UINT64_MAX;
+
+  for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
+    auto p = running_[cpu_id];
+    if (!p) continue;
+
+    p->vruntime += cfs_vruntime_delta(p->priority);
+
+    if (cpu_quantum_remaining_[cpu_id] > 0){
+      cpu_quantum_remaining_[cpu_id]--;
+    } else {
+      auto best = ready_queue_.peekNext();
+      if (best && best->vruntime < p->vruntime){
+        release_cpu_interrupt(cpu_id, p, interrupt);
+        dispatch_to_cpu(cpu_id);
+      }
+    }
+
+    if (running_[cpu_id]) floor = std::min(floor, running_[cpu_id]->vruntime);
+  }
+
+  auto leftmost = ready_queue_.peekNext();
+  if (leftmost) floor = std::min(floor, leftmost->vruntime);
+  if (floor != UINT64_MAX && floor > min_vruntime_.load()) min_vruntime_.store(floor);
+}
+
+// A ready process with an earlier deadline displaces the running process
+// with the latest deadline. Processes without a deadline count as having an
+// infinitely late one, so any deadline-tagged arrival can displace them.
+void Scheduler::edf_preemption()
+{
+  ProcessReturnContext interrupt = {ProcessState::READY, {}};
+  auto later = [](const std::shared_ptr<Process> &a, const std::shared_ptr<Process> &b) {
+    if (!a->deadline_tick) return b->deadline_tick != 0;
+    return b->deadline_tick && a->deadline_tick > b->deadline_tick;
+  };
+
+  for (uint32_t round = 0; round < this->cpu_capacity_; ++round){
+    auto best = ready_queue_.peekNext();
+    if (!best || !best->deadline_tick) return;
+
+    int64_t victim = -1;
+    for (uint32_t cpu_id = 0; cpu_id < this->cpu_capacity_; ++cpu_id){
+      if (!online_[cpu_id]) continue;
+      if (!running_[cpu_id]) return; // an idle core will pick it up in dispatch
+      if (victim < 0 || later(running_[cpu_id], running_[victim]))
+        victim = cpu_id;
+    }
+
+    if (victim < 0 || !later(running_[victim], best)) return;
+
+    release_cpu_interrupt(victim, running_[victim], interrupt);
+    dispatch_to_cpu(victim);
+  }
+}
+
+// Periodic boost to level 0 so demoted CPU-bound processes cannot starve.
+// Ready processes are re-keyed in place; running ones are reset directly.
+// Sleeping and not-yet-admitted processes are reset lazily in enqueue_ready
+// by comparing their epoch, so the sleep and job queues are never scanned.
+void Scheduler::mlfq_boost()
+{
+  uint32_t epoch = ++mlfq_epoch_;
+  ready_queue_.rekey([epoch](Process &p) {
+    p.mlfq_level = 0;
+    p.mlfq_epoch = epoch;
+  });
+
+  uint32_t ready = 0;
+  for (uint32_t level = 0; level < this->cfg_.mlfq_levels; ++level)
+    ready += mlfq_level_len_[level].exchange(0);
+  mlfq_level_len_[0].store(ready);
+
+  for (auto &p : running_){
+    if (!p) continue;
+    p->mlfq_level = 0;
+    p->mlfq_epoch = epoch;
+  }
+}
+
 void Scheduler::timer_check(){
   while(!sleep_queue_.empty() && sleep_queue_.top().wake_tick <= this->tick_){
     auto entry = sleep_queue_.top();
     sleep_queue_.pop();
-    entry.process->set_state(ProcessState::READY);
-    ready_queue_.send(entry.process);
+    mark(TimelineKind::WAKE, *entry.process);
+    enqueue_ready(entry.process);
   }
 }
 
@@ -218,12 +585,14 @@ void Scheduler::log_status(){
     std::cout << "Scheduler Tick " << this->tick_.load() << " completed.\n";
   #endif
   
-  if (this->tick_ % this->cfg_.snapshot_cooldown == 0)
+  if (this->tick_ % this->cfg_.snapshot_cooldown == 0) {
     log_queue.send(Scheduler::snapshot());
+    log_queue.trim(kKeptSnapshots);
+  }
 }
 
 void Scheduler::pause_check(){
-  std::unique_lock<std::mutex> lock(scheduler_mtx_);
+  TrackedLock lock(scheduler_mtx_);
   pause_cv_.wait(lock, [this]() { return !paused_.load(); });
   #if DEBUG_SCHEDULER
   std::cout << "Scheduler Tick " << this->tick_.load() << " starting. \n";
@@ -238,34 +607,60 @@ void Scheduler::tick_loop()
     Scheduler::pause_check();
 
     {
-      std::lock_guard<std::mutex> lock(scheduler_mtx_);
+      std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
+      Scheduler::mark_phase(TimelinePhase::HOUSEKEEPING);
+      Scheduler::drain_core_events();                                             // === 0. Yields from the previous tick ===
+      Scheduler::apply_hotplug();                                                 //        and cores onlined/offlined since
+      Scheduler::apply_pending_config();                                          //        and reloaded tunables
+      Scheduler::mark_phase(TimelinePhase::TIMERS);
       Scheduler::timer_check();
+      Scheduler::mark_phase(TimelinePhase::PREEMPTION);
       Scheduler::preemption_check();                                              // === 1. Preemption ===
-      Scheduler::tick_barrier_sync();
+      Scheduler::mark_phase(TimelinePhase::ADMISSION);
+      if (tick_hook_) tick_hook_(this->tick_.load());                             //        tick-driven arrivals
 
       if (!this->job_queue_.isEmpty())                                            // === 2. Long-term scheduling: admit new jobs ===
         Scheduler::long_term_admission();
       
       // empty for now                                                            // === 3. Middle-term scheduling: handle page faults, swapping ===
 
-      if (!this->ready_queue_.isEmpty())                                          // === 4. Short-term scheduling: dispatch to CPUs ===
+      Scheduler::mark_phase(TimelinePhase::DISPATCH);
+      if (!this->ready_queue_.isEmpty() || groups_enabled_)                       // === 4. Short-term scheduling: dispatch to CPUs ===
         Scheduler::short_term_dispatch();
-      
+
+      Scheduler::publish_assignments();
+      Scheduler::mark_phase(TimelinePhase::EXECUTE);
+      Scheduler::tick_barrier_sync();                                             // workers execute from here
+      Scheduler::tick_barrier_sync();                                             // workers have executed and counted this tick
+
+      Scheduler::mark_phase(TimelinePhase::LOG);
       Scheduler::log_status();                                                    // === 5. Log Status ===
 
+      Scheduler::mark_phase(TimelinePhase::ADVANCE);
+      Scheduler::sample_utilization();
+      this->tick_.fetch_add(1);                                                   // === 6. March forward the global tick ===
       Scheduler::tick_barrier_sync();
-      this->tick_.fetch_add(1);                                                   // === 5. March forward the global tick ===
-      Scheduler::tick_barrier_sync();
+      Scheduler::mark_phase(TimelinePhase::IDLE);
     }
 
     std::this_thread::sleep_for(std::chrono::milliseconds(Scheduler::get_scheduler_tick_delay()));
   }
+
+  // Workers are parked at the first barrier of the next tick. Flag them and
+  // complete that phase so they wake up, see the flag and exit.
+  for (auto &worker : cpu_workers_) if (worker) worker->stop();
+  Scheduler::tick_barrier_sync();
 }
 
 std::string Scheduler::cpu_state_snapshot(){
   std::ostringstream oss;
   auto t = std::time(nullptr);
-  auto tm = *std::localtime(&t);
+  std::tm tm{};
+#ifdef _WIN32
+  localtime_s(&tm, &t);
+#else
+  localtime_r(&t, &tm);
+#endif
   
   for (size_t i = 0; i < running_.size(); ++i){
     auto &proc = running_[i];
@@ -278,6 +673,8 @@ std::string Scheduler::cpu_state_snapshot(){
           << "Core: " << i << "\t"
           << proc->get_executed_instructions() << " / "
           << proc->get_total_instructions() << "\n";
+    else if (!online_[i])
+      oss << "  CPU " << i << ": OFFLINE\n";
     else
       oss << "  CPU " << i << ": IDLE\n";
   }
@@ -331,6 +728,24 @@ std::string Scheduler::snapshot() {
         ? "  (empty)\n" 
         : ready_queue_.snapshot());
   
+  if (this->cfg_.scheduler == MLFQ) {
+    oss << "[MLFQ Levels]\n";
+    auto lengths = mlfq_queue_lengths();
+    std::vector<uint32_t> quanta;
+    {
+      std::lock_guard<std::mutex> lock(reload_mtx_); // quanta follow a reloaded quantum-cycles
+      quanta = this->cfg_.mlfq_quanta;
+    }
+    for (size_t level = 0; level < lengths.size(); ++level)
+      oss << "  L" << level << " (q=" << quanta[level] << "): "
+          << lengths[level] << " ready\n";
+  }
+  
+  if (groups_enabled_) oss << "[CPU Groups]\n" << group_report();
+
+  std::string affinity = affinity_report();
+  if (!affinity.empty()) oss << "[Cache Affinity]\n" << affinity;
+
   // --- CPU States ---
   oss << "\n[CPU States]:\n";
   oss << cpu_state_snapshot();  
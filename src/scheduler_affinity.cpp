@@ -0,0 +1,84 @@
+#include "../include/scheduler.hpp"
+#include "../include/process.hpp"
+#include <sstream>
+
+// This file contains cache-affinity dispatch and migration accounting.
+//
+// A process "owns" a core's cache if it was the last process to run there.
+// With affinity on, dispatch skips processes whose previous core may still
+// pick them up within the affinity window; after the window they run on
+// whichever core asks first. Warm/cold dispatches and migrations are counted
+// in every mode so runs with and without affinity can be compared.
+
+// short_term_mtx_ held
+bool Scheduler::affinity_eligible(const Process &p, uint32_t cpu_id, uint32_t now) const {
+  if (p.cpu_id == UINT32_MAX) return true;               // never ran anywhere
+  if (!online_[p.cpu_id]) return true;                   // its core went offline
+  if (p.cpu_id == cpu_id) return true;
+  return now - p.ready_tick >= cfg_.affinity_window;     // waited long enough
+}
+
+// short_term_mtx_ held
+void Scheduler::affinity_account(Process &p, uint32_t cpu_id) {
+  bool ran_before = p.cpu_id != UINT32_MAX;
+  if (ran_before && p.cpu_id != cpu_id) {
+    ++p.migrations;
+    ++migrations_per_cpu_[cpu_id];
+  }
+
+  if (ran_before) {
+    bool warm = p.cpu_id == cpu_id && last_pid_on_cpu_[cpu_id] == p.id();
+    if (warm) {
+      ++warm_dispatches_;
+    } else {
+      ++cold_dispatches_;
+      if (cfg_.cache_cold_penalty) {
+        p.add_stall_ticks(cfg_.cache_cold_penalty);
+        cold_stall_ticks_ += cfg_.cache_cold_penalty;
+      }
+    }
+  }
+  last_pid_on_cpu_[cpu_id] = p.id();
+}
+
+AffinityStats Scheduler::affinity_stats() {
+  uint32_t penalty;
+  {
+    std::lock_guard<std::mutex> lock(reload_mtx_);
+    penalty = cfg_.cache_cold_penalty;
+  }
+  std::lock_guard<TrackedMutex> lock(short_term_mtx_);
+  AffinityStats s;
+  s.warm = warm_dispatches_;
+  s.cold = cold_dispatches_;
+  s.stall_ticks = cold_stall_ticks_;
+  s.stall_ticks_saved = warm_dispatches_ * penalty;
+  s.migrations_per_cpu = migrations_per_cpu_;
+  for (auto m : migrations_per_cpu_) s.migrations += m;
+  return s;
+}
+
+std::string Scheduler::affinity_report() {
+  bool affinity;
+  uint32_t window, penalty;
+  {
+    std::lock_guard<std::mutex> lock(reload_mtx_); // live keys; the scheduler thread applies them
+    affinity = cfg_.affinity;
+    window = cfg_.affinity_window;
+    penalty = cfg_.cache_cold_penalty;
+  }
+  if (!affinity && !penalty) return {};
+
+  AffinityStats s = affinity_stats();
+  std::ostringstream oss;
+  oss << "  Mode: " << (affinity ? "affinity" : "first-come")
+      << " (window " << window << ", cold penalty " << penalty << ")\n";
+  oss << "  Warm dispatches: " << s.warm << "  Cold dispatches: " << s.cold << "\n";
+  oss << "  Stall ticks: " << s.stall_ticks << "  Saved by warm cache: "
+      << s.stall_ticks_saved << "\n";
+  oss << "  Migrations: " << s.migrations << " (";
+  for (size_t cpu = 0; cpu < s.migrations_per_cpu.size(); ++cpu)
+    oss << (cpu ? " " : "") << cpu << ":" << s.migrations_per_cpu[cpu];
+  oss << ")\n";
+  return oss.str();
+}
@@ -0,0 +1,198 @@
+#include "../include/scheduler.hpp"
+#include "../include/process.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+// This file contains the CPU quota group (cgroup-like) accounting.
+//
+// Each group has a hard quota of core-ticks per accounting period and a share
+// that caps how many cores it may hold while other groups have ready work.
+// Enforcement only touches running processes (O(cores)) and group counters
+// (O(groups)) per tick; processes held back by their group are parked in the
+// group and handed back to the ready queue when capacity frees up.
+
+void Scheduler::initialize_groups() {
+  groups_enabled_ = !cfg_.groups.empty();
+  groups_ = std::vector<CpuGroup>(cfg_.groups.size() + 1);
+  groups_[0].name = "default";
+
+  for (size_t i = 0; i < cfg_.groups.size(); ++i) {
+    const auto &gc = cfg_.groups[i];
+    auto &g = groups_[i + 1];
+    g.name = gc.name;
+    g.share = gc.share;
+    g.quota_pct = gc.quota_pct;
+  }
+  rescale_groups();
+}
+
+void Scheduler::rescale_groups() {
+  uint32_t cpus = online_cpus_.load();
+  uint32_t total_share = 0;
+  for (const auto &gc : cfg_.groups) total_share += gc.share;
+
+  for (size_t i = 1; i < groups_.size(); ++i) {
+    auto &g = groups_[i];
+    if (g.quota_pct > 0 && g.quota_pct < 100)
+      g.quota_ticks = std::max<uint32_t>(1, g.quota_pct * cpus * cfg_.group_period / 100);
+    if (cfg_.groups.size() > 1)
+      g.core_cap = std::max<uint32_t>(1, (g.share * cpus + total_share - 1) / total_share);
+  }
+}
+
+uint32_t Scheduler::group_id(const std::string &name) const {
+  for (size_t i = 1; i < groups_.size(); ++i)
+    if (groups_[i].name == name) return static_cast<uint32_t>(i);
+  return 0;
+}
+
+bool Scheduler::group_can_run(const CpuGroup &g) const {
+  if (g.quota_ticks && g.used_in_period + g.running >= g.quota_ticks) return false;
+  if (g.core_cap && g.running >= g.core_cap) {
+    // Share cap only applies while another group is waiting for a core
+    for (const auto &other : groups_)
+      if (&other != &g && other.ready.load() > 0) return false;
+  }
+  return true;
+}
+
+// Called for each process taken off the ready queue by dispatch_to_cpu
+bool Scheduler::group_admit(const std::shared_ptr<Process> &p) {
+  auto &g = groups_[p->group_id];
+  g.ready.fetch_sub(1);
+  if (!group_can_run(g)) {
+    g.parked.push_back(p);
+    return false;
+  }
+  g.running++;
+  return true;
+}
+
+// Called whenever a process leaves a core. Frees a slot for one parked
+// process of the same group, if the quota still allows it.
+void Scheduler::group_released(const std::shared_ptr<Process> &p) {
+  auto &g = groups_[p->group_id];
+  g.running--;
+  if (g.parked.empty() || !group_can_run(g)) return;
+
+  auto next = g.parked.front();
+  g.parked.pop_front();
+  next->ticks_waited += this->tick_.load() - next->ready_tick;
+  enqueue_ready(next);
+}
+
+// Called by short_term_dispatch while cores sit idle. The share cap only
+// holds while another group has ready work, so once that work is gone the
+// capped group's parked processes go back to the ready queue, one per idle
+// core. Processes held back by their quota stay parked (group_can_run).
+bool Scheduler::group_fill_idle() {
+  if (!groups_enabled_) return false;
+  std::lock_guard<TrackedMutex> lock(short_term_mtx_);
+  uint32_t idle = 0;
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id)
+    if (online_[cpu_id] && !running_[cpu_id]) ++idle;
+
+  uint32_t now = this->tick_.load();
+  bool unparked = false;
+  for (auto &g : groups_) {
+    while (idle && !g.parked.empty() && group_can_run(g)) {
+      auto next = g.parked.front();
+      g.parked.pop_front();
+      next->ticks_waited += now - next->ready_tick;
+      enqueue_ready(next);
+      --idle;
+      unparked = true;
+    }
+  }
+  return unparked;
+}
+
+// Runs at the start of every tick (before preemption decisions).
+void Scheduler::group_accounting() {
+  if (!groups_enabled_) return;
+
+  uint32_t now = this->tick_.load();
+  std::vector<uint32_t> over_quota;
+  std::vector<std::shared_ptr<Process>> unpark;
+  {
+    std::lock_guard<TrackedMutex> lock(short_term_mtx_);
+
+    if (now % cfg_.group_period == 0) {
+      // New period: budgets refill and every parked process gets another go
+      for (auto &g : groups_) {
+        g.used_in_period = 0;
+        unpark.insert(unpark.end(), g.parked.begin(), g.parked.end());
+        g.parked.clear();
+      }
+    }
+
+    // Charge the tick each running process just executed to its group
+    for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) {
+      auto &p = running_[cpu_id];
+      if (!p) continue;
+      auto &g = groups_[p->group_id];
+      g.used_in_period++;
+      g.used_total++;
+    }
+
+    // Throttle: keep only as many of a group's processes on cores as its
+    // remaining budget can pay for in the coming tick
+    for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) {
+      auto p = running_[cpu_id];
+      if (!p) continue;
+      auto &g = groups_[p->group_id];
+      if (!g.quota_ticks || g.used_in_period + g.running <= g.quota_ticks) continue;
+
+      running_[cpu_id] = nullptr;
+      latency_preemption(*p);
+      trace(TraceKind::PREEMPT, *p, cpu_id);
+      mark(TimelineKind::PREEMPT, *p, cpu_id);
+      g.running--;
+      p->set_state(ProcessState::READY);
+      p->ready_tick = now;
+      g.parked.push_back(p);
+      over_quota.push_back(cpu_id);
+    }
+
+    for (auto &g : groups_)
+      if (g.quota_ticks && g.used_in_period >= g.quota_ticks && (g.ready.load() > 0 || !g.parked.empty()))
+        g.throttled_ticks++;
+  }
+
+  for (auto &p : unpark) {
+    p->ticks_waited += now - p->ready_tick;
+    enqueue_ready(p);
+  }
+  for (uint32_t cpu_id : over_quota) dispatch_to_cpu(cpu_id);
+}
+
+std::vector<GroupUsage> Scheduler::group_usage() {
+  std::lock_guard<TrackedMutex> lock(short_term_mtx_);
+  std::vector<GroupUsage> out;
+  for (const auto &g : groups_)
+    out.push_back({g.name, g.share, g.quota_pct, g.used_total, g.throttled_ticks,
+                   g.running, g.ready.load(), static_cast<uint32_t>(g.parked.size())});
+  return out;
+}
+
+std::string Scheduler::group_report() {
+  if (!groups_enabled_) return {};
+
+  uint64_t capacity = static_cast<uint64_t>(this->tick_.load()) * online_cpus_.load();
+  std::ostringstream oss;
+  oss << "  " << std::left << std::setw(14) << "Group" << std::right
+      << std::setw(6) << "Share" << std::setw(7) << "Quota" << std::setw(7) << "Util"
+      << std::setw(5) << "Run" << std::setw(7) << "Ready" << std::setw(8) << "Parked"
+      << std::setw(11) << "Throttled" << "\n";
+  for (const auto &u : group_usage()) {
+    uint64_t util = capacity ? (u.used_total * 100 / capacity) : 0;
+    oss << "  " << std::left << std::setw(14) << u.name << std::right
+        << std::setw(6) << u.share
+        << std::setw(6) << (u.quota_pct ? std::to_string(u.quota_pct) : "-") << "%"
+        << std::setw(6) << util << "%"
+        << std::setw(5) << u.running << std::setw(7) << u.ready << std::setw(8) << u.parked
+        << std::setw(11) << u.throttled_ticks << "\n";
+  }
+  return oss.str();
+}
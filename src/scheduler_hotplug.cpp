@@ -0,0 +1,90 @@
+#include "../include/scheduler.hpp"
+#include "../include/process.hpp"
+
+// This file contains runtime core hotplug (cpu-online / cpu-offline).
+//
+// All per-core state is allocated for max(num_cpu, max_cpu) slots up front.
+// Requests are queued from any thread and applied by the scheduler thread at
+// the start of a tick, before it reaches the first tick barrier: an onlined
+// core's worker joins the barrier from that tick on, while an offlined core's
+// worker passes the first barrier once more, sees it was stopped and leaves
+// with arrive_and_drop(). Its running process goes back to the ready queue.
+
+bool Scheduler::is_cpu_online(uint32_t cpu_id) const {
+  return cpu_id < cpu_capacity_ && online_[cpu_id].load();
+}
+
+bool Scheduler::request_cpu_online(uint32_t cpu_id) {
+  std::lock_guard<std::mutex> lock(hotplug_mtx_);
+  if (cpu_id >= cpu_capacity_ || hotplug_target_[cpu_id]) return false;
+  hotplug_target_[cpu_id] = true;
+  hotplug_requests_.push_back({cpu_id, true});
+  return true;
+}
+
+bool Scheduler::request_cpu_offline(uint32_t cpu_id) {
+  std::lock_guard<std::mutex> lock(hotplug_mtx_);
+  if (cpu_id >= cpu_capacity_ || !hotplug_target_[cpu_id]) return false;
+  uint32_t remaining = 0;
+  for (bool online : hotplug_target_) remaining += online;
+  if (remaining <= 1) return false;
+  hotplug_target_[cpu_id] = false;
+  hotplug_requests_.push_back({cpu_id, false});
+  return true;
+}
+
+void Scheduler::apply_hotplug() {
+  std::vector<std::pair<uint32_t, bool>> requests;
+  {
+    std::lock_guard<std::mutex> lock(hotplug_mtx_);
+    if (hotplug_requests_.empty()) return;
+    requests.swap(hotplug_requests_);
+  }
+
+  // Only each slot's last request counts. An offline + online pair in one
+  // batch must be a no-op: onlining would join the old worker, which is
+  // parked in this tick's first barrier waiting for this thread. Onlining
+  // first keeps at least one core up throughout.
+  std::vector<int8_t> target(cpu_capacity_, -1);
+  for (auto [cpu_id, online] : requests) target[cpu_id] = online;
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id)
+    if (target[cpu_id] == 1) cpu_online(cpu_id);
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id)
+    if (target[cpu_id] == 0) cpu_offline(cpu_id);
+  rescale_groups();
+}
+
+void Scheduler::cpu_online(uint32_t cpu_id) {
+  if (online_[cpu_id]) return;
+
+  // A previous worker for this slot has already left the barrier
+  if (cpu_workers_[cpu_id]) cpu_workers_[cpu_id]->join();
+
+  cpu_quantum_remaining_[cpu_id] = cfg_.quantum_cycles - 1;
+  mailboxes_[cpu_id].barrier_round = 0;   // the old worker left after its first round
+  mailboxes_[cpu_id].tick_wait_ns = 0;
+  online_[cpu_id] = true;
+  online_cpus_.fetch_add(1);
+
+  // The barrier must count the new worker before it can arrive; safe since
+  // this thread has not arrived yet this tick
+  tick_sync_barrier_->add(1);
+  cpu_workers_[cpu_id] = std::make_shared<CPUWorker>(cpu_id, *this);
+  cpu_workers_[cpu_id]->start();
+  if (pinned_.worker_cpus.size() > cpu_id) {
+    int host_cpu = pinning_plan().worker_cpus[cpu_id];
+    pinned_.worker_cpus[cpu_id] = (host_cpu >= 0 && cpu_workers_[cpu_id]->pin(host_cpu)) ? host_cpu : -1;
+  }
+}
+
+void Scheduler::cpu_offline(uint32_t cpu_id) {
+  if (!online_[cpu_id]) return;
+
+  if (running_[cpu_id])
+    release_cpu_interrupt(cpu_id, running_[cpu_id], {ProcessState::READY, {}});
+
+  online_[cpu_id] = false;
+  online_cpus_.fetch_sub(1);
+  mailboxes_[cpu_id].assigned.store(nullptr, std::memory_order_release);
+  if (cpu_workers_[cpu_id]) cpu_workers_[cpu_id]->stop();
+}
@@ -0,0 +1,80 @@
+#include "../include/scheduler.hpp"
+#include "../include/process.hpp"
+#include <iomanip>
+#include <sstream>
+
+// This file contains per-process latency accounting. Each process is stamped
+// on arrival, first dispatch, every preemption and finish; response time is
+// recorded at the first dispatch and the rest once it finishes. Recording
+// happens under short_term_mtx_, so each histogram has a single writer at a
+// time and readers never take a scheduler lock.
+
+void Scheduler::initialize_latency() {
+  this->latency_ = std::make_unique<LatencyHistograms[]>(groups_.size() + 1);
+}
+
+void Scheduler::latency_arrival(Process &p) {
+  p.stamp_arrival(this->tick_.load());
+}
+
+void Scheduler::latency_dispatch(Process &p, uint32_t now) {
+  if (!p.stamp_dispatch(now)) return;
+  uint64_t response = now - p.get_metrics().created_tick;
+  latency_[0].response.record(response);
+  if (groups_enabled_) latency_[1 + p.group_id].response.record(response);
+}
+
+void Scheduler::latency_preemption(Process &p) {
+  p.stamp_preemption();
+}
+
+void Scheduler::latency_finish(Process &p, uint32_t finish_tick) {
+  ProcessMetrics m = p.get_metrics();
+  for (size_t i : {size_t{0}, size_t{1} + p.group_id}) {
+    if (i > 0 && !groups_enabled_) break;
+    LatencyHistograms &h = latency_[i];
+    h.waiting.record(p.ticks_waited);
+    h.turnaround.record(finish_tick - m.created_tick);
+    h.preemptions.record(m.preemptions);
+  }
+}
+
+std::vector<LatencySnapshot> Scheduler::latency() const {
+  std::vector<LatencySnapshot> out;
+  size_t rows = groups_enabled_ ? groups_.size() + 1 : 1;
+  for (size_t i = 0; i < rows; ++i) {
+    LatencySnapshot s;
+    s.label = i == 0 ? policy_name(cfg_.scheduler) : "group " + groups_[i - 1].name;
+    s.response = latency_[i].response.snapshot();
+    s.waiting = latency_[i].waiting.snapshot();
+    s.turnaround = latency_[i].turnaround.snapshot();
+    s.preemptions = latency_[i].preemptions.snapshot();
+    out.push_back(std::move(s));
+  }
+  return out;
+}
+
+std::string Scheduler::latency_report() const {
+  std::vector<LatencySnapshot> rows = latency();
+  if (rows[0].response.count() == 0) return {};
+
+  std::ostringstream oss;
+  oss << "Latency (ticks)\n"
+      << "  " << std::left << std::setw(28) << "" << std::right << std::setw(8) << "n"
+      << std::setw(8) << "p50" << std::setw(8) << "p90" << std::setw(8) << "p99"
+      << std::setw(8) << "max" << "\n";
+  auto line = [&](const std::string &label, const char *metric, const LogLinearHistogram &h) {
+    oss << "  " << std::left << std::setw(28) << (label + " " + metric) << std::right
+        << std::setw(8) << h.count() << std::setw(8) << h.percentile(0.50)
+        << std::setw(8) << h.percentile(0.90) << std::setw(8) << h.percentile(0.99)
+        << std::setw(8) << h.max() << "\n";
+  };
+  for (const auto &r : rows) {
+    if (r.response.count() == 0) continue;
+    line(r.label, "response", r.response);
+    line(r.label, "waiting", r.waiting);
+    line(r.label, "turnaround", r.turnaround);
+    line(r.label, "preemptions", r.preemptions);
+  }
+  return oss.str();
+}
@@ -0,0 +1,86 @@
+#include "../include/scheduler.hpp"
+#include <iomanip>
+#include <sstream>
+
+// This file contains the per-opcode execution profile behind vmstat. Each
+// worker counts the instructions it executes into its own OpcodeProfile
+// (see Process::execute_tick), so the hot path has no shared writes; the
+// report sums the cores. Admission adds every program's source and
+// unrolled lengths, which shows how much FOR expansion inflates the fleet.
+
+static constexpr const char *kOpcodeNames[OpcodeProfile::kOpcodes] = {
+    "PRINT", "DECLARE", "ADD", "SUBTRACT", "SLEEP", "FOR"};
+
+void Scheduler::initialize_opcode_profile() {
+  if (!cfg_.opcode_profile) return;
+  this->opcode_profile_ = std::make_unique<OpcodeProfile[]>(cpu_capacity_);
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id)
+    opcode_profile_[cpu_id].sample_period = cfg_.opcode_sample;
+}
+
+void Scheduler::opcode_arrival(const Process &p) {
+  if (!opcode_profile_) return;
+  relaxed_add(admitted_programs_, 1); // scheduler thread only
+  relaxed_add(admitted_source_, p.get_source_instructions());
+  relaxed_add(admitted_unrolled_, p.get_total_instructions());
+}
+
+OpcodeStats Scheduler::opcode_stats() const {
+  OpcodeStats s;
+  if (!opcode_profile_) return s;
+  s.enabled = true;
+  s.sample_period = cfg_.opcode_sample;
+  s.opcodes.resize(OpcodeProfile::kOpcodes);
+  s.per_core.resize(cpu_capacity_);
+  for (size_t op = 0; op < OpcodeProfile::kOpcodes; ++op) s.opcodes[op].type = static_cast<InstructionType>(op);
+
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) {
+    const OpcodeProfile &core = opcode_profile_[cpu_id];
+    for (size_t op = 0; op < OpcodeProfile::kOpcodes; ++op) {
+      uint64_t executed = core.executed[op].load(std::memory_order_relaxed);
+      s.opcodes[op].executed += executed;
+      s.opcodes[op].sampled += core.sampled[op].load(std::memory_order_relaxed);
+      s.opcodes[op].sampled_ns += core.sampled_ns[op].load(std::memory_order_relaxed);
+      s.per_core[cpu_id] += executed;
+    }
+  }
+  s.programs = admitted_programs_.load(std::memory_order_relaxed);
+  s.source_instructions = admitted_source_.load(std::memory_order_relaxed);
+  s.unrolled_instructions = admitted_unrolled_.load(std::memory_order_relaxed);
+  return s;
+}
+
+std::string Scheduler::opcode_stats_report() const {
+  OpcodeStats s = opcode_stats();
+  if (!s.enabled) return "Opcode profile is off; set opcode-profile true in config.txt\n";
+
+  uint64_t total = 0;
+  for (const auto &c : s.opcodes) total += c.executed;
+
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1);
+  oss << "Instructions executed: " << total;
+  if (s.sample_period) oss << " (timing 1 in " << s.sample_period << ")";
+  oss << "\n  " << std::left << std::setw(10) << "opcode" << std::right << std::setw(14) << "executed"
+      << std::setw(8) << "share" << std::setw(10) << "sampled" << std::setw(10) << "mean ns"
+      << std::setw(10) << "est ms" << "\n";
+  for (const auto &c : s.opcodes) {
+    double mean_ns = c.sampled ? static_cast<double>(c.sampled_ns) / c.sampled : 0.0;
+    oss << "  " << std::left << std::setw(10) << kOpcodeNames[static_cast<size_t>(c.type)] << std::right
+        << std::setw(14) << c.executed << std::setw(7) << (total ? 100.0 * c.executed / total : 0.0) << "%"
+        << std::setw(10) << c.sampled << std::setw(10) << mean_ns
+        << std::setw(10) << mean_ns * c.executed / 1e6 << "\n";
+  }
+
+  oss << "Per core:";
+  for (uint32_t cpu_id = 0; cpu_id < s.per_core.size(); ++cpu_id)
+    if (s.per_core[cpu_id] || cpu_id < cfg_.num_cpu) oss << " cpu" << cpu_id << "=" << s.per_core[cpu_id];
+  oss << "\n";
+
+  oss << std::setprecision(2) << "Programs: " << s.programs << " admitted, " << s.source_instructions
+      << " source -> " << s.unrolled_instructions << " unrolled instructions";
+  if (s.source_instructions)
+    oss << " (x" << static_cast<double>(s.unrolled_instructions) / s.source_instructions << ")";
+  oss << "\n";
+  return oss.str();
+}
@@ -0,0 +1,128 @@
+#include "../include/scheduler.hpp"
+#include <iomanip>
+#include <sstream>
+
+// This file contains the always-on tick profiler behind sched-prof. The
+// scheduler thread timestamps every tick_loop phase change (the points the
+// timeline marks), and each worker times its three barrier rounds. Every
+// histogram has a single writer, so recording is a clock read and a few
+// relaxed atomic updates; readers never take a scheduler lock.
+
+static constexpr const char *kRoundNames[3] = {"dispatch", "execute", "advance"};
+
+void Scheduler::initialize_profile() {
+  this->phase_profile_ = std::make_unique<PhaseProfile[]>(kTimelinePhases);
+}
+
+void Scheduler::profile_phase(TimelinePhase phase) {
+  auto now = std::chrono::steady_clock::now();
+  uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phase_started_at_).count();
+  uint32_t generation = profile_generation_.load(std::memory_order_relaxed);
+
+  PhaseProfile &ended = phase_profile_[static_cast<size_t>(current_phase_)];
+  relaxed_add(ended.total_ns, ns);
+  ended.recent[generation & 1].record(ns);
+  current_phase_ = phase;
+  phase_started_at_ = now;
+
+  // Generations only change between ticks, so every phase of a tick lands
+  // in the same one
+  if (phase != TimelinePhase::HOUSEKEEPING ||
+      now - generation_started_at_ < std::chrono::milliseconds(kProfileGenerationMs))
+    return;
+  for (size_t i = 0; i < kTimelinePhases; ++i) phase_profile_[i].recent[(generation + 1) & 1].clear();
+  profile_generation_.store(generation + 1, std::memory_order_relaxed);
+  generation_started_at_ = now;
+}
+
+void Scheduler::profile_barrier_wait(uint32_t cpu_id, uint64_t ns) {
+  CoreMailbox &m = mailboxes_[cpu_id];
+  uint32_t round = m.barrier_round;
+  relaxed_add(m.round_wait_ns[round], ns);
+  m.tick_wait_ns += ns;
+  if (round < 2) {
+    m.barrier_round = round + 1;
+    return;
+  }
+
+  uint32_t generation = profile_generation_.load(std::memory_order_relaxed);
+  if (generation != m.profile_generation) {
+    // A worker that sat out whole generations (offline core) clears both
+    if (generation - m.profile_generation > 1) m.tick_wait[(generation + 1) & 1].clear();
+    m.tick_wait[generation & 1].clear();
+    m.profile_generation = generation;
+  }
+  m.tick_wait[generation & 1].record(m.tick_wait_ns);
+  m.barrier_round = 0;
+  m.tick_wait_ns = 0;
+}
+
+TickProfile Scheduler::tick_profile() const {
+  TickProfile p;
+  p.ticks = tick_.load();
+  if (sched_running_.load())
+    p.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at_).count();
+
+  for (size_t i = 0; i < kTimelinePhases; ++i) {
+    PhaseCost c;
+    c.phase = static_cast<TimelinePhase>(i);
+    c.total_ns = phase_profile_[i].total_ns.load(std::memory_order_relaxed);
+    c.recent = phase_profile_[i].recent[0].snapshot();
+    c.recent.merge(phase_profile_[i].recent[1].snapshot());
+    p.phases.push_back(std::move(c));
+  }
+
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) {
+    const CoreMailbox &m = mailboxes_[cpu_id];
+    WorkerWait w;
+    w.cpu = cpu_id;
+    w.online = online_[cpu_id].load();
+    uint64_t waited = 0;
+    for (size_t r = 0; r < 3; ++r) waited += w.round_ns[r] = m.round_wait_ns[r].load(std::memory_order_relaxed);
+    if (!waited && !w.online) continue;
+    w.recent = m.tick_wait[0].snapshot();
+    w.recent.merge(m.tick_wait[1].snapshot());
+    p.workers.push_back(std::move(w));
+  }
+  return p;
+}
+
+std::string Scheduler::tick_profile_report() const {
+  TickProfile p = tick_profile();
+  uint64_t total_ns = 0;
+  for (const auto &c : p.phases) total_ns += c.total_ns;
+  if (total_ns == 0) return "Tick profile: no ticks yet\n";
+
+  auto us = [](uint64_t ns) { return ns / 1000.0; };
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1);
+  oss << "Tick profile: " << p.ticks << " ticks";
+  if (p.wall_seconds > 0) oss << " in " << p.wall_seconds << " s (" << p.ticks / p.wall_seconds << " ticks/s)";
+  oss << "\n  percentiles cover the last " << kProfileGenerationMs / 1000 << "-"
+      << 2 * kProfileGenerationMs / 1000 << " s\n";
+
+  oss << "  " << std::left << std::setw(14) << "phase" << std::right << std::setw(8) << "share"
+      << std::setw(12) << "total ms" << std::setw(10) << "p50 us" << std::setw(10) << "p90 us"
+      << std::setw(10) << "p99 us" << std::setw(10) << "max us" << "\n";
+  for (const auto &c : p.phases) {
+    oss << "  " << std::left << std::setw(14) << timeline_phase_name(c.phase) << std::right
+        << std::setw(7) << 100.0 * c.total_ns / total_ns << "%" << std::setw(12) << c.total_ns / 1e6
+        << std::setw(10) << us(c.recent.percentile(0.50)) << std::setw(10) << us(c.recent.percentile(0.90))
+        << std::setw(10) << us(c.recent.percentile(0.99)) << std::setw(10) << us(c.recent.max()) << "\n";
+  }
+
+  if (p.workers.empty()) return oss.str();
+  // Round shares are of the scheduler's profiled time, which covers every tick
+  oss << "Worker barrier wait (share of tick time per round; per-tick total)\n"
+      << "  " << std::left << std::setw(10) << "cpu" << std::right;
+  for (const char *round : kRoundNames) oss << std::setw(10) << round;
+  oss << std::setw(10) << "p50 us" << std::setw(10) << "p90 us" << std::setw(10) << "p99 us"
+      << std::setw(10) << "max us" << "\n";
+  for (const auto &w : p.workers) {
+    oss << "  " << std::left << std::setw(10) << (std::to_string(w.cpu) + (w.online ? "" : " (off)")) << std::right;
+    for (uint64_t ns : w.round_ns) oss << std::setw(9) << 100.0 * ns / total_ns << "%";
+    oss << std::setw(10) << us(w.recent.percentile(0.50)) << std::setw(10) << us(w.recent.percentile(0.90))
+        << std::setw(10) << us(w.recent.percentile(0.99)) << std::setw(10) << us(w.recent.max()) << "\n";
+  }
+  return oss.str();
+}
@@ -0,0 +1,124 @@
+#include "../include/scheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#ifdef __linux__
+#include <pthread.h>
+#include <time.h>
+#endif
+
+// This file contains tick-cost and dispatch-latency reporting, used by the
+// scalability benchmark, and the per-core utilization behind report-util.
+// Counters are cumulative; utilization windows come from a sampled series.
+
+LogLinearHistogram Scheduler::dispatch_latency() {
+  std::lock_guard<TrackedMutex> lock(short_term_mtx_);
+  return dispatch_latency_;
+}
+
+// Finished waits plus the elapsed part of one in progress at `now`. The
+// start is read on both sides of the total; if it changed, a wait began or
+// ended in between and the read is retried.
+static uint64_t waited_until(const std::atomic<uint64_t> &done, const std::atomic<int64_t> &since, int64_t now) {
+  for (;;) {
+    int64_t started = since.load();
+    uint64_t total = done.load();
+    if (since.load() != started) continue;
+    return total + (started && now > started ? static_cast<uint64_t>(now - started) : 0);
+  }
+}
+
+// Lock-free; may run concurrently with a tick, so the tick and core-tick
+// counters are only consistent to within one tick of each other. Barrier
+// waits and wall time are taken at the same instant.
+TickStats Scheduler::tick_stats() const {
+  TickStats s;
+  s.ticks = tick_.load();
+  s.participants = online_cpus_.load();
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) {
+    s.busy_core_ticks += mailboxes_[cpu_id].busy_ticks.load(std::memory_order_relaxed);
+    s.idle_core_ticks += mailboxes_[cpu_id].idle_ticks.load(std::memory_order_relaxed);
+  }
+  if (!sched_running_.load()) return s;
+
+  auto now = std::chrono::steady_clock::now();
+  int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  s.wall_seconds = std::chrono::duration<double>(now - started_at_).count();
+  s.scheduler_barrier_seconds = waited_until(sched_barrier_wait_ns_, sched_waiting_since_ns_, now_ns) / 1e9;
+  uint64_t worker_ns = 0;
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id)
+    if (online_[cpu_id].load())
+      worker_ns += waited_until(mailboxes_[cpu_id].barrier_wait_ns, mailboxes_[cpu_id].waiting_since_ns, now_ns);
+  s.worker_barrier_seconds = worker_ns / 1e9;
+
+  s.scheduler_cpu_seconds = -1;
+#ifdef __linux__
+  clockid_t clock;
+  timespec ts;
+  if (pthread_getcpuclockid(const_cast<std::thread &>(sched_thread_).native_handle(), &clock) == 0 &&
+      clock_gettime(clock, &ts) == 0)
+    s.scheduler_cpu_seconds = ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+  return s;
+}
+
+// === Utilization ===
+
+void Scheduler::sample_utilization() {
+  auto now = std::chrono::steady_clock::now();
+  if (util_count_ > 0 && now - util_last_ < std::chrono::milliseconds(kUtilizationSampleMs)) return;
+  util_last_ = now;
+
+  UtilizationSample sample{now, 0, 0};
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) {
+    sample.busy += mailboxes_[cpu_id].busy_ticks.load(std::memory_order_relaxed);
+    sample.idle += mailboxes_[cpu_id].idle_ticks.load(std::memory_order_relaxed);
+  }
+  std::lock_guard<std::mutex> lock(util_mtx_);
+  util_ring_[util_next_] = sample;
+  util_next_ = (util_next_ + 1) % kUtilizationSlots;
+  util_count_ = std::min(util_count_ + 1, kUtilizationSlots);
+}
+
+UtilizationReport Scheduler::utilization() {
+  UtilizationReport r;
+  r.online = online_cpus_.load();
+  r.cores.resize(cpu_capacity_);
+  uint64_t busy = 0, idle = 0;
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) {
+    CoreUtilization &c = r.cores[cpu_id];
+    c.online = online_[cpu_id].load();
+    c.busy = c.online && mailboxes_[cpu_id].assigned.load(std::memory_order_acquire) != nullptr;
+    c.busy_ticks = mailboxes_[cpu_id].busy_ticks.load(std::memory_order_relaxed);
+    c.idle_ticks = mailboxes_[cpu_id].idle_ticks.load(std::memory_order_relaxed);
+    r.busy_now += c.busy;
+    busy += c.busy_ticks;
+    idle += c.idle_ticks;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(util_mtx_);
+  // i-th oldest sample; samples are in time order
+  auto at = [&](size_t i) -> const UtilizationSample & {
+    return util_ring_[(util_next_ + kUtilizationSlots - util_count_ + i) % kUtilizationSlots];
+  };
+  for (uint32_t seconds : {1u, 10u, 60u}) {
+    UtilizationWindow w;
+    w.seconds = seconds;
+    if (util_count_ > 0) {
+      // Newest sample at least `seconds` old, or the oldest one there is
+      auto cutoff = now - std::chrono::seconds(seconds);
+      size_t lo = 0, hi = util_count_;
+      while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (at(mid).at <= cutoff) lo = mid + 1;
+        else hi = mid;
+      }
+      const UtilizationSample &from = at(lo > 0 ? lo - 1 : 0);
+      w.covered_seconds = std::chrono::duration<double>(now - from.at).count();
+      w.busy_ticks = busy - from.busy;
+      w.idle_ticks = idle - from.idle;
+    }
+    r.windows.push_back(w);
+  }
+  return r;
+}
@@ -2,21 +2,66 @@
 #include "../include/process.hpp"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <iomanip>
 
 // This files just contains Scheduler's Utility functions
 
 void Scheduler::initialize_vectors() {
-  this->running_ = std::vector<std::shared_ptr<Process>>(cfg_.num_cpu, nullptr);
-  this->busy_ticks_per_cpu_ = std::vector<uint64_t>(cfg_.num_cpu, 0);
-  this->cpu_quantum_remaining_ = std::vector<uint32_t>(cfg_.num_cpu, cfg_.quantum_cycles - 1);
+  // Every per-core structure is sized for all core slots so that hotplug
+  // never reallocates anything a worker might be reading
+  this->running_ = std::vector<std::shared_ptr<Process>>(cpu_capacity_, nullptr);
+  this->util_ring_ = std::vector<UtilizationSample>(kUtilizationSlots);
+  this->cpu_quantum_remaining_ = std::vector<uint32_t>(cpu_capacity_, cfg_.quantum_cycles - 1);
+  this->mailboxes_ = std::make_unique<CoreMailbox[]>(cpu_capacity_);
+  this->last_pid_on_cpu_ = std::vector<uint32_t>(cpu_capacity_, UINT32_MAX);
+  this->migrations_per_cpu_ = std::vector<uint64_t>(cpu_capacity_, 0);
+  this->online_ = std::make_unique<std::atomic<bool>[]>(cpu_capacity_);
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) online_[cpu_id] = cpu_id < cfg_.num_cpu;
+  this->online_cpus_ = cfg_.num_cpu;
+  this->hotplug_target_ = std::vector<bool>(cpu_capacity_);
+  for (uint32_t cpu_id = 0; cpu_id < cpu_capacity_; ++cpu_id) hotplug_target_[cpu_id] = cpu_id < cfg_.num_cpu;
+
+  if (cfg_.mlfq_levels == 0) cfg_.mlfq_levels = 1;
+  this->mlfq_quanta_derived_ = cfg_.mlfq_quanta.empty();
+  fill_mlfq_quanta();
+  this->mlfq_level_len_ = std::make_unique<std::atomic<uint32_t>[]>(cfg_.mlfq_levels);
+}
+
+// MLFQ: fill in missing per-level quanta by doubling from quantum_cycles
+void Scheduler::fill_mlfq_quanta() {
+  auto &quanta = cfg_.mlfq_quanta;
+  if (quanta.empty()) quanta.push_back(std::max<uint32_t>(1, cfg_.quantum_cycles));
+  while (quanta.size() < cfg_.mlfq_levels) quanta.push_back(quanta.back() * 2);
+  quanta.resize(cfg_.mlfq_levels);
+  for (auto &q : quanta) q = std::max<uint32_t>(1, q);
 }
 
+bool Scheduler::uses_quantum_cycles() const {
+  return cfg_.scheduler == RR || (cfg_.scheduler == MLFQ && mlfq_quanta_derived_);
+}
+
+uint32_t Scheduler::quantum_for(const Process &p) const {
+  if (cfg_.scheduler == MLFQ) return cfg_.mlfq_quanta[p.mlfq_level];
+  if (cfg_.scheduler == CFS) return cfg_.cfs_min_granularity;
+  return cfg_.quantum_cycles;
+}
+
+std::vector<uint32_t> Scheduler::mlfq_queue_lengths() const {
+  std::vector<uint32_t> out;
+  if (!mlfq_level_len_) return out;
+  for (uint32_t level = 0; level < cfg_.mlfq_levels; ++level)
+    out.push_back(mlfq_level_len_[level].load());
+  return out;
+}
+
+// Called by a worker leaving the tick (core offlined or scheduler stopping)
 void Scheduler::stop_barrier_sync() {
   this->tick_sync_barrier_->arrive_and_drop();
 }
 
 void Scheduler::pause() {
-  std::lock_guard<std::mutex> lock(scheduler_mtx_);
+  std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
   paused_.store(true);
   #if DEBUG_SCHEDULER
   std::cout <<"Paused.\n";
@@ -25,7 +70,7 @@ void Scheduler::pause() {
 
 void Scheduler::resume() {
   {
-    std::lock_guard<std::mutex> lock(scheduler_mtx_);
+    std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
     paused_.store(false);
   }
   pause_cv_.notify_all(); // release tick_loop wait
@@ -39,7 +84,7 @@ uint32_t Scheduler::current_tick() const { return tick_.load(); }
 
 std::string Scheduler::get_sched_snapshots(){
   auto snapshots = this->log_queue.snapshot();
-  this->log_queue.empty();
+  this->log_queue.clear();
   return snapshots;
 }
 
@@ -47,15 +92,170 @@ void Scheduler::setSchedulingPolicy(SchedulingPolicy policy_){
   this->ready_queue_.setPolicy(policy_);
 }
 
+// The start of a wait is published so tick_stats can count waits still in
+// progress; it is cleared only after the finished wait has been added.
+static int64_t steady_ns(std::chrono::steady_clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
 void Scheduler::tick_barrier_sync()
 {
+  auto begin = std::chrono::steady_clock::now();
+  sched_waiting_since_ns_.store(steady_ns(begin));
   this->tick_sync_barrier_->arrive_and_wait();
+  auto waited = std::chrono::steady_clock::now() - begin;
+  sched_barrier_wait_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count());
+  sched_waiting_since_ns_.store(0);
 }
 
-uint32_t Scheduler::get_cpu_count() const { return cfg_.num_cpu; };
+void Scheduler::tick_barrier_sync(uint32_t cpu_id)
+{
+  CoreMailbox &m = mailboxes_[cpu_id];
+  auto begin = std::chrono::steady_clock::now();
+  m.waiting_since_ns.store(steady_ns(begin));
+  this->tick_sync_barrier_->arrive_and_wait();
+  auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+  m.barrier_wait_ns.fetch_add(waited);
+  m.waiting_since_ns.store(0);
+  profile_barrier_wait(cpu_id, waited);
+}
+
+void Scheduler::set_tick_hook(TickHook hook) {
+  std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
+  tick_hook_ = std::move(hook);
+}
+
+void Scheduler::set_trace_hook(TraceHook hook) {
+  std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
+  trace_hook_ = std::move(hook);
+}
+
+// Records from the next tick on; closed when the scheduler stops
+bool Scheduler::record_trace(const std::string &path) {
+  auto writer = std::make_unique<SchedTraceWriter>();
+  if (!writer->open(path, cfg_)) return false;
+  SchedTraceWriter *w = writer.get();
+  set_trace_hook([w](TraceKind kind, uint32_t tick, const Process &p, uint32_t cpu) { w->record(kind, tick, p, cpu); });
+  recorder_ = std::move(writer);
+  return true;
+}
+
+void Scheduler::set_event_feed(std::shared_ptr<EventFeed> feed) {
+  std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
+  event_feed_ = std::move(feed);
+}
+
+PinLayout Scheduler::pinning() const { return pinned_; }
+
+std::string Scheduler::pinning_report() const {
+  if (cfg_.pin_scheduler < 0 && cfg_.pin_workers == "none") return {};
+
+  auto describe = [](int cpu) { return cpu >= 0 ? "host " + std::to_string(cpu) : std::string("unpinned"); };
+  PinLayout plan = pinning_plan();
+  std::ostringstream oss;
+  oss << "Thread pinning (" << cfg_.pin_workers << ", " << pinned_.host_cpus.size()
+      << " host CPUs available):\n";
+  oss << "  scheduler -> " << describe(pinned_.scheduler_cpu);
+  if (plan.scheduler_cpu != pinned_.scheduler_cpu) oss << " (host " << plan.scheduler_cpu << " refused)";
+  oss << "\n";
+  for (size_t i = 0; i < pinned_.worker_cpus.size(); ++i) {
+    oss << "  cpu " << i << " -> " << describe(pinned_.worker_cpus[i]);
+    if (plan.worker_cpus[i] != pinned_.worker_cpus[i]) oss << " (host " << plan.worker_cpus[i] << " refused)";
+    oss << "\n";
+  }
+  return oss.str();
+}
+
+void Scheduler::reload_config(const Config &next) {
+  std::lock_guard<std::mutex> lock(reload_mtx_);
+  pending_cfg_ = next;
+}
+
+// Runs on the scheduler thread before the first tick barrier, so workers
+// (which read delay_per_exec while executing) never see a half-applied config
+void Scheduler::apply_pending_config() {
+  std::lock_guard<std::mutex> lock(reload_mtx_);
+  if (!pending_cfg_) return;
+
+  uint32_t aging_ticks = cfg_.aging_ticks;
+  uint32_t quantum_cycles = cfg_.quantum_cycles;
+  apply_live_keys(cfg_, *pending_cfg_);
+  pending_cfg_.reset();
+  if (cfg_.aging_ticks != aging_ticks) ready_queue_.setAging(cfg_.aging_ticks);
+  if (mlfq_quanta_derived_ && cfg_.quantum_cycles != quantum_cycles) {
+    // Same level count, so this rewrites the quanta in place
+    cfg_.mlfq_quanta.clear();
+    fill_mlfq_quanta();
+  }
+}
+
+bool Scheduler::is_idle() {
+  std::lock_guard<TrackedMutex> lock(scheduler_mtx_);
+  if (!job_queue_.isEmpty() || !ready_queue_.isEmpty() || !sleep_queue_.empty()) return false;
+  for (const auto &p : running_) if (p) return false;
+  for (const auto &g : groups_) if (!g.parked.empty()) return false;
+  return true;
+}
+
+size_t Scheduler::finished_count() { return finished_.size(); }
+
+uint32_t Scheduler::get_cpu_count() const { return online_cpus_.load(); };
+
+uint32_t Scheduler::get_cpu_capacity() const { return cpu_capacity_; }
 
 uint32_t Scheduler::get_scheduler_tick_delay() const { return cfg_.scheduler_tick_delay; }
 
+uint32_t Scheduler::get_delay_per_exec() const { return cfg_.delay_per_exec; }
+
+
+// === DEADLINE ACCOUNTING ===
+
+const char *const DeadlineSummary::kBucketLabels[DeadlineSummary::kBuckets] = {
+  "<= -100", "-99..0", "1..10", "11..100", "101..1000", "> 1000"
+};
+
+static size_t lateness_bucket(int64_t lateness) {
+  if (lateness <= -100) return 0;
+  if (lateness <= 0) return 1;
+  if (lateness <= 10) return 2;
+  if (lateness <= 100) return 3;
+  if (lateness <= 1000) return 4;
+  return 5;
+}
+
+void Scheduler::record_deadline_outcome(const std::shared_ptr<Process> &p, uint32_t finish_tick) {
+  int64_t lateness = static_cast<int64_t>(finish_tick) - static_cast<int64_t>(p->deadline_tick);
+  std::lock_guard<std::mutex> lock(deadline_mtx_);
+  uint64_t finished = deadline_stats_.met + deadline_stats_.missed;
+  if (lateness <= 0) deadline_stats_.met++;
+  else deadline_stats_.missed++;
+  deadline_stats_.total_lateness += lateness;
+  if (finished == 0 || lateness > deadline_stats_.max_lateness) deadline_stats_.max_lateness = lateness;
+  deadline_stats_.lateness[lateness_bucket(lateness)]++;
+}
+
+DeadlineSummary Scheduler::deadline_summary() {
+  std::lock_guard<std::mutex> lock(deadline_mtx_);
+  return deadline_stats_;
+}
+
+std::string Scheduler::deadline_report() {
+  DeadlineSummary s = deadline_summary();
+  uint64_t finished = s.met + s.missed;
+  if (finished == 0 && s.flagged == 0 && s.rejected == 0) return {};
+
+  std::ostringstream oss;
+  oss << "Deadlines: " << s.met << " met, " << s.missed << " missed, "
+      << s.flagged << " flagged, " << s.rejected << " rejected\n";
+  if (finished > 0) {
+    oss << "Lateness (ticks): mean " << (s.total_lateness / static_cast<int64_t>(finished))
+        << ", max " << s.max_lateness << "\n";
+    for (size_t i = 0; i < DeadlineSummary::kBuckets; ++i)
+      oss << "  " << std::left << std::setw(10) << DeadlineSummary::kBucketLabels[i]
+          << std::right << s.lateness[i] << "\n";
+  }
+  return oss.str();
+}
 
 // === SHORT TERM SCHEDULER ALGORITHM IMPLEMENTATION ===
 bool ProcessComparer::operator()(const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) const {
@@ -76,10 +276,75 @@ ProcessCmpFn rr_cmp = [](const ProcessPtr &a, const ProcessPtr &b) {
 
 ProcessCmpFn prio_cmp = [](const ProcessPtr &a, const ProcessPtr &b) {
 
-  if (a->priority == b->priority) return a->id() < b->id();
+  if (a->priority == b->priority) {
+    if (a->ready_tick == b->ready_tick) return a->id() < b->id();
+    return a->ready_tick < b->ready_tick;
+  }
   return a->priority > b->priority;
 };
 
+ProcessCmpFn mlfq_cmp = [](const ProcessPtr &a, const ProcessPtr &b) {
+  if (a->mlfq_level != b->mlfq_level) return a->mlfq_level < b->mlfq_level;
+  if (a->ready_tick == b->ready_tick) return a->id() < b->id();
+  return a->ready_tick < b->ready_tick;
+};
+
+ProcessCmpFn cfs_cmp = [](const ProcessPtr &a, const ProcessPtr &b) {
+  if (a->vruntime == b->vruntime) return a->id() < b->id();
+  return a->vruntime < b->vruntime;
+};
+
+// Deadline-tagged processes first, earliest deadline first; the rest FCFS
+ProcessCmpFn edf_cmp = [](const ProcessPtr &a, const ProcessPtr &b) {
+  bool da = a->deadline_tick > 0, db = b->deadline_tick > 0;
+  if (da != db) return da;
+  if (a->deadline_tick != b->deadline_tick) return a->deadline_tick < b->deadline_tick;
+  if (a->ready_tick == b->ready_tick) return a->id() < b->id();
+  return a->ready_tick < b->ready_tick;
+};
+
+// Same weights as Linux's sched_prio_to_weight (nice -20 .. 19); each step
+// is ~1.25x so one priority level is ~10% more CPU under contention.
+static const uint32_t kPrioToWeight[40] = {
+  88761, 71755, 56483, 46273, 36291,
+  29154, 23254, 18705, 14949, 11916,
+   9548,  7620,  6100,  4904,  3906,
+   3121,  2501,  1991,  1586,  1277,
+   1024,   820,   655,   526,   423,
+    335,   272,   215,   172,   137,
+    110,    87,    70,    56,    45,
+     36,    29,    23,    18,    15,
+};
+
+uint32_t cfs_weight(uint32_t priority) {
+  return kPrioToWeight[20 - std::min<uint32_t>(priority, 20)];
+}
+
+uint64_t cfs_vruntime_delta(uint32_t priority) {
+  return (1024ull * 1024ull) / cfs_weight(priority);
+}
+
+// Aging without rescanning the queue: a process gains +1 priority per
+// `aging_ticks` waited, so its effective priority at tick t is
+//   priority + (t - ready_tick) / aging_ticks.
+// Comparing two waiting processes at any t reduces to comparing
+//   priority * aging_ticks - ready_tick,
+// which is fixed at enqueue time. The multiset order therefore stays valid
+// as time passes and aging costs nothing per tick.
+static ProcessCmpFn make_aged_prio_cmp(uint32_t aging_ticks) {
+  return [aging_ticks](const ProcessPtr &a, const ProcessPtr &b) {
+    int64_t rank_a = static_cast<int64_t>(a->priority) * aging_ticks - a->ready_tick;
+    int64_t rank_b = static_cast<int64_t>(b->priority) * aging_ticks - b->ready_tick;
+    if (rank_a == rank_b) return a->id() < b->id();
+    return rank_a > rank_b;
+  };
+}
+
+uint32_t effective_priority(const Process &p, uint32_t now, uint32_t aging_ticks) {
+  if (aging_ticks == 0 || now <= p.ready_tick) return p.priority;
+  return p.priority + (now - p.ready_tick) / aging_ticks;
+}
+
 // === DynamicVictimChannel Implementation ===
 
 void DynamicVictimChannel::setPolicy(SchedulingPolicy algo) {
@@ -87,9 +352,14 @@ void DynamicVictimChannel::setPolicy(SchedulingPolicy algo) {
   reformatQueue();
 }
 
+void DynamicVictimChannel::setAging(uint32_t aging_ticks) {
+  aging_ticks_ = aging_ticks;
+  reformatQueue();
+}
+
 // Rebuild the victimQ_ based on current comparator_
 void DynamicVictimChannel::reformatQueue() {
-  std::lock_guard<std::mutex> lock(messageMtx_);
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
   switch (policy_) {
     case RR:
       comparator_ = rr_cmp;
@@ -98,7 +368,16 @@ void DynamicVictimChannel::reformatQueue() {
       comparator_ = fcfs_cmp;
       break;
     case PRIORITY:
-      comparator_ = prio_cmp;
+      comparator_ = (aging_ticks_ > 0) ? make_aged_prio_cmp(aging_ticks_) : prio_cmp;
+      break;
+    case MLFQ:
+      comparator_ = mlfq_cmp;
+      break;
+    case CFS:
+      comparator_ = cfs_cmp;
+      break;
+    case EDF:
+      comparator_ = edf_cmp;
       break;
     default:
       comparator_ = fcfs_cmp; // Default comparer
@@ -110,32 +389,45 @@ void DynamicVictimChannel::reformatQueue() {
   this->comparator_ = comparator_;
 }
 
-DynamicVictimChannel::DynamicVictimChannel(SchedulingPolicy algo)
-    : policy_(algo) {
+// Applies fn to every queued process and rebuilds the order. Needed when the
+// fields the comparator reads change for queued processes (e.g. MLFQ boost).
+void DynamicVictimChannel::rekey(const std::function<void(Process &)> &fn) {
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
+  std::vector<std::shared_ptr<Process>> procs(victimQ_.begin(), victimQ_.end());
+  victimQ_.clear();
+  for (auto &proc : procs) fn(*proc);
+  victimQ_.insert(procs.begin(), procs.end());
+}
+
+DynamicVictimChannel::DynamicVictimChannel(SchedulingPolicy algo, uint32_t aging_ticks)
+    : policy_(algo), aging_ticks_(aging_ticks) {
   DynamicVictimChannel::reformatQueue();
 }
 
 std::string DynamicVictimChannel::snapshot() {
-  std::lock_guard<std::mutex> lock(messageMtx_);
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
   std::stringstream ss;
 
   ss << "DVC Snapshot: " << victimQ_.size() << " processes\n";
   for (const auto &proc : victimQ_) {
-      ss << "PID=" << proc->id() << ", Name=" << proc->name() << ", " << " LA=" << proc->last_active_tick << "\n";
+      ss << "PID=" << proc->id() << ", Name=" << proc->name() << ", " << " LA=" << proc->last_active_tick << " PR=" << proc->priority;
+      if (policy_ == CFS) ss << " VR=" << proc->vruntime;
+      if (policy_ == EDF && proc->deadline_tick) ss << " DL=" << proc->deadline_tick;
+      ss << "\n";
   }
   return ss.str();
 }
 
 void DynamicVictimChannel::send(const std::shared_ptr<Process> &msg) {
   {
-    std::lock_guard<std::mutex> lock(messageMtx_);
+    std::lock_guard<TrackedMutex> lock(messageMtx_);
     this->victimQ_.insert(msg);
   }
   messageCv_.notify_one();
 }
 
 std::shared_ptr<Process> DynamicVictimChannel::receiveNext() {
-  std::unique_lock<std::mutex> lock(messageMtx_);
+  TrackedLock lock(messageMtx_);
   messageCv_.wait(lock, [this]{ return !victimQ_.empty(); });
   auto it = victimQ_.begin();
   std::shared_ptr<Process> msg = *it;
@@ -144,7 +436,7 @@ std::shared_ptr<Process> DynamicVictimChannel::receiveNext() {
 }
 
 std::shared_ptr<Process> DynamicVictimChannel::receiveVictim() {
-  std::unique_lock<std::mutex> lock(messageMtx_);
+  TrackedLock lock(messageMtx_);
   messageCv_.wait(lock, [this]{ return !victimQ_.empty(); });
   auto it = std::prev(victimQ_.end()); // 
   std::shared_ptr<Process> msg = *it;
@@ -152,8 +444,27 @@ std::shared_ptr<Process> DynamicVictimChannel::receiveVictim() {
   return msg;
 }
 
+// Non-blocking look at the process receiveNext() would return
+std::shared_ptr<Process> DynamicVictimChannel::peekNext() {
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
+  return victimQ_.empty() ? nullptr : *victimQ_.begin();
+}
+
+std::shared_ptr<Process> DynamicVictimChannel::receiveFirst(
+    const std::function<bool(const Process &)> &pred, size_t limit) {
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
+  size_t scanned = 0;
+  for (auto it = victimQ_.begin(); it != victimQ_.end() && scanned < limit; ++it, ++scanned) {
+    if (!pred(**it)) continue;
+    std::shared_ptr<Process> msg = *it;
+    victimQ_.erase(it);
+    return msg;
+  }
+  return nullptr;
+}
+
 // Accessor
 bool DynamicVictimChannel::isEmpty() {
-  std::lock_guard<std::mutex> lock(messageMtx_);
+  std::lock_guard<TrackedMutex> lock(messageMtx_);
   return victimQ_.empty();
 }
@@ -0,0 +1,215 @@
+#include "../include/shadow.hpp"
+#include "../include/scheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+static constexpr auto kPollInterval = std::chrono::milliseconds(10);
+static constexpr size_t kPeriodsKept = 10;
+
+// === Model ===
+
+ShadowModel::ShadowModel(SchedulingPolicy policy, uint32_t cores, uint32_t quantum)
+    : policy_(policy == RR || policy == PRIORITY ? policy : FCFS),
+      quantum_(std::max<uint32_t>(1, quantum)),
+      cores_(std::max<uint32_t>(1, cores)) {}
+
+ShadowModel::ReadyKey ShadowModel::key_of(const Job &j) const {
+  uint64_t rank = policy_ == PRIORITY ? UINT32_MAX - j.priority : 0; // higher priority first
+  return {rank, j.seq};
+}
+
+void ShadowModel::make_ready(uint32_t pid) {
+  Job &j = jobs_[pid];
+  j.seq = next_seq_++;
+  ready_.insert({key_of(j), pid});
+}
+
+// Fills idle cores; under PRIORITY a better ready job also displaces the
+// worst running one
+void ShadowModel::dispatch() {
+  for (auto &c : cores_) {
+    if (c.busy || ready_.empty()) continue;
+    c = Core{ready_.begin()->second, true, quantum_};
+    ready_.erase(ready_.begin());
+  }
+  if (policy_ != PRIORITY) return;
+
+  while (!ready_.empty()) {
+    Core *victim = nullptr;
+    for (auto &c : cores_)
+      if (c.busy && (!victim || jobs_[c.pid].priority < jobs_[victim->pid].priority)) victim = &c;
+    if (!victim || ready_.begin()->first >= key_of(jobs_[victim->pid])) return;
+    uint32_t displaced = victim->pid;
+    *victim = Core{ready_.begin()->second, true, quantum_};
+    ready_.erase(ready_.begin());
+    make_ready(displaced);
+  }
+}
+
+void ShadowModel::arrive(uint64_t tick, uint32_t pid, uint64_t service, uint32_t priority) {
+  advance_to(tick);
+  Job &j = jobs_[pid];
+  j.arrival = std::max(tick, now_);
+  j.service = j.remaining = std::max<uint64_t>(1, service);
+  j.priority = priority;
+  make_ready(pid);
+  dispatch();
+}
+
+// Jumps from event to event: the next completion or, under RR, quantum
+// expiry on any core
+void ShadowModel::advance_to(uint64_t tick) {
+  for (;;) {
+    dispatch();
+    if (now_ >= tick) return;
+
+    uint64_t step = tick - now_;
+    bool any = false;
+    for (const auto &c : cores_) {
+      if (!c.busy) continue;
+      any = true;
+      step = std::min(step, jobs_[c.pid].remaining);
+      if (policy_ == RR) step = std::min(step, c.quantum_left);
+    }
+    now_ += step;
+    if (!any) return;
+
+    for (auto &c : cores_) {
+      if (!c.busy) continue;
+      Job &j = jobs_[c.pid];
+      j.remaining -= step;
+      if (policy_ == RR) c.quantum_left -= step;
+      if (j.remaining == 0) {
+        turnaround_.record(now_ - j.arrival);
+        waiting_.record(now_ - j.arrival - j.service);
+        jobs_.erase(c.pid);
+        c.busy = false;
+      } else if (policy_ == RR && c.quantum_left == 0) {
+        if (ready_.empty()) {
+          c.quantum_left = quantum_;
+        } else {
+          make_ready(c.pid);
+          c.busy = false;
+        }
+      }
+    }
+  }
+}
+
+// === Live Comparison ===
+
+ShadowScheduler::ShadowScheduler(Scheduler &sched, const Config &live, SchedulingPolicy policy, uint32_t quantum)
+    : sched_(sched), feed_(std::make_shared<EventFeed>()), policy_(policy),
+      quantum_(std::max<uint32_t>(1, quantum)), cores_(std::max<uint32_t>(1, live.num_cpu)),
+      live_policy_(live.scheduler), delay_per_exec_(live.delay_per_exec),
+      cooldown_(std::max<uint32_t>(1, live.snapshot_cooldown)),
+      model_(policy, cores_, quantum_) {}
+
+ShadowScheduler::~ShadowScheduler() { stop(); }
+
+void ShadowScheduler::start() {
+  if (running_.exchange(true)) return;
+  sched_.set_event_feed(feed_);
+  thread_ = std::thread(&ShadowScheduler::loop, this);
+}
+
+void ShadowScheduler::stop() {
+  if (!running_.exchange(false)) return;
+  sched_.set_event_feed(nullptr); // returns once no tick is pushing to it
+  if (thread_.joinable()) thread_.join();
+}
+
+void ShadowScheduler::loop() {
+  while (running_.load()) {
+    poll();
+    std::this_thread::sleep_for(kPollInterval);
+  }
+}
+
+void ShadowScheduler::poll() {
+  // Events are pushed before the tick counter moves on, so once it reads T
+  // every event of tick T - 1 is in the feed
+  const uint32_t live_tick = sched_.current_tick();
+  std::lock_guard<std::mutex> lock(model_mtx_);
+  FeedEvent e;
+  while (feed_->events.tryPop(e)) {
+    if (e.kind == FeedEvent::ARRIVAL) {
+      live_arrival_[e.pid] = e.tick;
+      model_.arrive(e.tick, e.pid, static_cast<uint64_t>(e.instructions) * (1 + delay_per_exec_), e.priority);
+      continue;
+    }
+    auto it = live_arrival_.find(e.pid);
+    if (it == live_arrival_.end()) continue; // arrived before the shadow attached
+    live_turnaround_.record(e.tick - it->second);
+    live_waiting_.record(e.waited);
+    live_arrival_.erase(it);
+  }
+  if (live_tick > 0) model_.advance_to(std::max<uint64_t>(model_.now(), live_tick - 1));
+
+  const uint64_t period = live_tick / cooldown_;
+  if (period != last_period_) {
+    last_period_ = period;
+    periods_.push_back(period_line(period * cooldown_));
+    if (periods_.size() > kPeriodsKept) periods_.pop_front();
+  }
+}
+
+// Cumulative means at a period boundary
+std::string ShadowScheduler::period_line(uint64_t tick) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1) << "    tick " << std::setw(8) << tick
+      << ": waiting " << live_waiting_.mean() << " live / " << model_.waiting().mean() << " shadow"
+      << ", turnaround " << live_turnaround_.mean() << " live / " << model_.turnaround().mean() << " shadow\n";
+  return oss.str();
+}
+
+std::string ShadowScheduler::describe() const {
+  std::ostringstream oss;
+  oss << policy_name(policy_);
+  if (policy_ == RR) oss << " q=" << quantum_;
+  oss << " on " << cores_ << " cores";
+  return oss.str();
+}
+
+std::string ShadowScheduler::build_report() {
+  const LogLinearHistogram &sw = model_.waiting(), &st = model_.turnaround();
+  auto row = [](std::ostringstream &oss, const char *label, const LogLinearHistogram &w, const LogLinearHistogram &t) {
+    oss << "  " << std::left << std::setw(8) << label << std::right << std::setw(10) << t.count()
+        << std::setw(11) << w.mean() << std::setw(10) << w.percentile(0.99)
+        << std::setw(11) << t.mean() << std::setw(10) << t.percentile(0.99) << "\n";
+  };
+  auto delta = [](double shadow, double live) {
+    std::ostringstream oss;
+    oss << std::showpos << std::fixed << std::setprecision(1);
+    if (live > 0) oss << 100.0 * (shadow - live) / live << "%";
+    else oss << "n/a";
+    return oss.str();
+  };
+
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1);
+  oss << "Shadow " << describe() << " vs live " << policy_name(live_policy_) << " at tick " << model_.now()
+      << " (" << model_.in_flight() << " in flight";
+  if (uint64_t dropped = feed_->dropped.load()) oss << ", " << dropped << " events dropped";
+  oss << ")\n";
+  oss << "  " << std::left << std::setw(8) << "" << std::right << std::setw(10) << "finished"
+      << std::setw(11) << "wait mean" << std::setw(10) << "wait p99"
+      << std::setw(11) << "turn mean" << std::setw(10) << "turn p99" << "\n";
+  row(oss, "live", live_waiting_, live_turnaround_);
+  row(oss, "shadow", sw, st);
+  oss << "  shadow vs live: waiting " << delta(sw.mean(), live_waiting_.mean())
+      << ", turnaround " << delta(st.mean(), live_turnaround_.mean()) << "\n";
+  if (!periods_.empty()) {
+    oss << "  every " << cooldown_ << " ticks:\n";
+    for (const auto &line : periods_) oss << line;
+  }
+  return oss.str();
+}
+
+std::string ShadowScheduler::report() {
+  poll();
+  std::lock_guard<std::mutex> lock(model_mtx_);
+  return build_report();
+}
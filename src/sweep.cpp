@@ -0,0 +1,234 @@
+#include "../include/sweep.hpp"
+#include "../include/process.hpp"
+#include "../include/process_generator.hpp"
+#include "../include/scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+static std::vector<std::string> split_list(const std::string &v) {
+  std::vector<std::string> out;
+  std::stringstream ss(v);
+  for (std::string item; std::getline(ss, item, ',');)
+    if (!item.empty()) out.push_back(item);
+  return out;
+}
+
+bool parse_sweep_axis(const std::string &spec, SweepAxis &out, std::string &error) {
+  size_t eq = spec.find('=');
+  out.key = spec.substr(0, eq);
+  out.values = eq == std::string::npos ? std::vector<std::string>{} : split_list(spec.substr(eq + 1));
+  if (out.key.empty() || out.values.empty()) {
+    error = "expected key=value[,value...], got " + spec;
+    return false;
+  }
+  for (const auto &v : out.values) {
+    Config scratch;
+    try {
+      if (!set_config_key(scratch, out.key, v)) {
+        error = "unknown config key " + out.key;
+        return false;
+      }
+    } catch (...) {
+      error = "bad value " + v + " for " + out.key;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sweep_workload(const SweepOptions &opts, std::vector<WorkloadRecord> &out, std::string &error) {
+  out.clear();
+  if (opts.workload_trace.empty()) {
+    Scheduler scratch(opts.base); // only for group lookups; never started
+    ProcessGenerator gen(opts.base, scratch);
+    out = gen.sample_workload(opts.processes);
+    return true;
+  }
+  WorkloadTraceReader reader;
+  if (!reader.open(opts.workload_trace, error)) return false;
+  for (WorkloadRecord rec; reader.next(rec);) out.push_back(std::move(rec));
+  if (reader.bad_lines() > 0) {
+    error = opts.workload_trace + ": " + std::to_string(reader.bad_lines()) +
+            " malformed lines, first at " + reader.first_error();
+    return false;
+  }
+  return true;
+}
+
+// === One Point ===
+
+SweepPoint run_sweep_point(const Config &point_cfg, const std::vector<WorkloadRecord> &workload, uint32_t max_ticks) {
+  Config cfg = point_cfg;
+  cfg.scheduler_tick_delay = 0;
+  cfg.snapshot_cooldown = UINT32_MAX;
+  cfg.record_trace.clear();
+  cfg.watch_config = false;
+  cfg.pin_scheduler = -1;
+  cfg.pin_workers = "none";
+
+  Scheduler sched(cfg);
+  const uint32_t group = sched.group_id(cfg.generator_group);
+
+  // Scheduler thread only until stop()
+  bool started = false;
+  uint32_t first_tick = 0;
+  uint32_t last_finish = 0;
+  std::unordered_map<uint32_t, uint32_t> arrived; // pid -> tick
+  LogLinearHistogram turnaround, waiting;
+  std::atomic<size_t> next{0};
+
+  sched.set_tick_hook([&](uint32_t tick) {
+    if (!started) {
+      started = true;
+      first_tick = tick;
+    }
+    size_t i = next.load(std::memory_order_relaxed);
+    for (; i < workload.size() && workload[i].tick <= tick - first_tick; ++i) {
+      const WorkloadRecord &rec = workload[i];
+      auto p = std::make_shared<Process>(static_cast<uint32_t>(i + 1), rec.name, *rec.program);
+      p->priority = rec.priority;
+      p->deadline = rec.deadline;
+      p->group_id = group;
+      sched.submit_process(std::move(p));
+    }
+    next.store(i, std::memory_order_release);
+  });
+  sched.set_trace_hook([&](TraceKind kind, uint32_t tick, const Process &p, uint32_t) {
+    if (kind == TraceKind::ARRIVAL) {
+      arrived[p.id()] = tick;
+    } else if (kind == TraceKind::FINISH) {
+      turnaround.record(tick - arrived[p.id()]);
+      waiting.record(p.ticks_waited);
+      last_finish = tick;
+    }
+  });
+
+  SweepPoint r;
+  auto t0 = std::chrono::steady_clock::now();
+  const uint32_t start_tick = sched.current_tick();
+  sched.start();
+  for (;;) {
+    r.completed = next.load(std::memory_order_acquire) == workload.size() && sched.is_idle();
+    if (r.completed || sched.current_tick() - start_tick >= max_ticks) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  sched.stop();
+  r.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+  r.ticks = std::max<uint32_t>(1, (r.completed ? last_finish : sched.current_tick()) - first_tick);
+  r.finished = turnaround.count();
+  r.throughput = 1000.0 * static_cast<double>(r.finished) / r.ticks;
+  r.mean_turnaround = turnaround.mean();
+  r.p99_turnaround = turnaround.percentile(0.99);
+  r.mean_waiting = waiting.mean();
+  r.p99_waiting = waiting.percentile(0.99);
+  r.utilization = std::min(1.0, static_cast<double>(sched.tick_stats().busy_core_ticks) /
+                                    (static_cast<double>(std::max<uint32_t>(1, cfg.num_cpu)) * r.ticks));
+  return r;
+}
+
+// === Grid ===
+
+bool run_sweep(const SweepOptions &opts, std::vector<SweepPoint> &out, std::string &error) {
+  std::vector<WorkloadRecord> workload;
+  if (!sweep_workload(opts, workload, error)) return false;
+
+  // Cartesian product, last axis fastest
+  std::vector<std::vector<std::string>> combos{{}};
+  for (const auto &axis : opts.grid) {
+    std::vector<std::vector<std::string>> next;
+    for (const auto &prefix : combos)
+      for (const auto &v : axis.values) {
+        next.push_back(prefix);
+        next.back().push_back(v);
+      }
+    combos = std::move(next);
+  }
+
+  std::vector<Config> configs;
+  for (const auto &values : combos) {
+    Config cfg = opts.base;
+    for (size_t a = 0; a < values.size(); ++a) set_config_key(cfg, opts.grid[a].key, values[a]);
+    configs.push_back(cfg);
+  }
+
+  out.assign(configs.size(), SweepPoint{});
+  std::atomic<size_t> next_point{0};
+  auto worker = [&] {
+    for (size_t i; (i = next_point.fetch_add(1)) < configs.size();) {
+      out[i] = run_sweep_point(configs[i], workload, opts.max_ticks);
+      out[i].values = combos[i];
+    }
+  };
+
+  uint32_t jobs = opts.jobs ? opts.jobs : std::max(1u, std::thread::hardware_concurrency());
+  jobs = std::min<uint32_t>(jobs, static_cast<uint32_t>(configs.size()));
+  std::vector<std::thread> pool;
+  for (uint32_t j = 1; j < jobs; ++j) pool.emplace_back(worker);
+  worker();
+  for (auto &t : pool) t.join();
+  return true;
+}
+
+// === Output ===
+
+static std::vector<std::string> sweep_header(const SweepOptions &opts) {
+  std::vector<std::string> h;
+  for (const auto &axis : opts.grid) h.push_back(axis.key);
+  for (const char *c : {"ticks", "finished", "per_1k_ticks", "turnaround_mean", "turnaround_p99",
+                        "waiting_mean", "waiting_p99", "utilization", "wall_ms", "completed"})
+    h.push_back(c);
+  return h;
+}
+
+static std::vector<std::string> sweep_row(const SweepPoint &p) {
+  auto fixed = [](double v, int digits) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(digits) << v;
+    return oss.str();
+  };
+  std::vector<std::string> row = p.values;
+  row.push_back(std::to_string(p.ticks));
+  row.push_back(std::to_string(p.finished));
+  row.push_back(fixed(p.throughput, 2));
+  row.push_back(fixed(p.mean_turnaround, 1));
+  row.push_back(std::to_string(p.p99_turnaround));
+  row.push_back(fixed(p.mean_waiting, 1));
+  row.push_back(std::to_string(p.p99_waiting));
+  row.push_back(fixed(p.utilization, 3));
+  row.push_back(fixed(p.wall_ms, 1));
+  row.push_back(p.completed ? "yes" : "no");
+  return row;
+}
+
+std::string sweep_table(const SweepOptions &opts, const std::vector<SweepPoint> &points) {
+  std::vector<std::vector<std::string>> rows{sweep_header(opts)};
+  for (const auto &p : points) rows.push_back(sweep_row(p));
+  std::vector<size_t> width(rows[0].size(), 0);
+  for (const auto &row : rows)
+    for (size_t c = 0; c < row.size(); ++c) width[c] = std::max(width[c], row[c].size());
+
+  std::ostringstream oss;
+  for (const auto &row : rows) {
+    for (size_t c = 0; c < row.size(); ++c)
+      oss << (c ? "  " : "") << std::setw(static_cast<int>(width[c])) << row[c];
+    oss << "\n";
+  }
+  return oss.str();
+}
+
+std::string sweep_csv(const SweepOptions &opts, const std::vector<SweepPoint> &points) {
+  std::ostringstream oss;
+  auto line = [&](const std::vector<std::string> &row) {
+    for (size_t c = 0; c < row.size(); ++c) oss << (c ? "," : "") << row[c];
+    oss << "\n";
+  };
+  line(sweep_header(opts));
+  for (const auto &p : points) line(sweep_row(p));
+  return oss.str();
+}
@@ -0,0 +1,66 @@
+#include "../include/thread_pinning.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+std::vector<int> host_cpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+  }
+#endif
+  if (cpus.empty()) {
+    int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int cpu = 0; cpu < n; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+PinLayout plan_pinning(const Config &cfg, const std::vector<int> &host) {
+  PinLayout layout;
+  layout.host_cpus = host;
+  layout.scheduler_cpu = cfg.pin_scheduler;
+  layout.worker_cpus.assign(cfg.num_cpu, -1);
+  if (host.empty()) return layout;
+
+  if (cfg.pin_workers == "list") {
+    for (size_t i = 0; i < layout.worker_cpus.size() && i < cfg.pin_worker_cpus.size(); ++i)
+      layout.worker_cpus[i] = static_cast<int>(cfg.pin_worker_cpus[i]);
+    return layout;
+  }
+  if (cfg.pin_workers != "compact" && cfg.pin_workers != "scatter") return layout;
+
+  // Leave the scheduler its own CPU unless that would force workers to share
+  std::vector<int> pool;
+  for (int cpu : host)
+    if (cpu != cfg.pin_scheduler) pool.push_back(cpu);
+  if (pool.size() < cfg.num_cpu) pool = host;
+
+  size_t stride = 1;
+  if (cfg.pin_workers == "scatter" && cfg.num_cpu > 0)
+    stride = std::max<size_t>(1, pool.size() / cfg.num_cpu);
+  for (size_t i = 0; i < layout.worker_cpus.size(); ++i)
+    layout.worker_cpus[i] = pool[(i * stride) % pool.size()]; // wraps if workers > CPUs
+  return layout;
+}
+
+bool pin_thread(std::thread &t, int host_cpu) {
+#ifdef __linux__
+  if (host_cpu < 0 || host_cpu >= CPU_SETSIZE || !t.joinable()) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(host_cpu, &set);
+  return pthread_setaffinity_np(t.native_handle(), sizeof(set), &set) == 0;
+#else
+  (void)t;
+  (void)host_cpu;
+  return false;
+#endif
+}
@@ -0,0 +1,44 @@
+#include "../include/tick_barrier.hpp"
+
+TickBarrier::TickBarrier(uint32_t participants) : expected_(participants) {}
+
+void TickBarrier::arrive_and_wait() { arrive(true); }
+
+void TickBarrier::arrive_and_drop() {
+  pending_drops_.fetch_add(1, std::memory_order_relaxed);
+  arrive(false);
+}
+
+void TickBarrier::add(uint32_t participants) {
+  expected_.fetch_add(participants, std::memory_order_acq_rel);
+}
+
+uint32_t TickBarrier::participants() const {
+  return expected_.load(std::memory_order_acquire);
+}
+
+void TickBarrier::arrive(bool wait) {
+  uint64_t s = state_.fetch_add(1, std::memory_order_acq_rel) + 1;
+  uint64_t generation = s >> 32;
+  uint32_t arrived = static_cast<uint32_t>(s);
+
+  if (arrived == expected_.load(std::memory_order_acquire)) {
+    // Last one in: shrink for leavers, then open the next generation
+    expected_.fetch_sub(pending_drops_.exchange(0, std::memory_order_acq_rel),
+                        std::memory_order_acq_rel);
+    state_.store((generation + 1) << 32, std::memory_order_release);
+    state_.notify_all();
+    return;
+  }
+  if (!wait) return;
+
+  // Ticks are short, so spin briefly before sleeping on the futex
+  for (int spin = 0; spin < 128; ++spin)
+    if ((state_.load(std::memory_order_acquire) >> 32) != generation) return;
+
+  uint64_t cur = state_.load(std::memory_order_acquire);
+  while ((cur >> 32) == generation) {
+    state_.wait(cur, std::memory_order_acquire);
+    cur = state_.load(std::memory_order_acquire);
+  }
+}
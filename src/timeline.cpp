@@ -0,0 +1,209 @@
+#include "../include/timeline.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+// === Ring ===
+
+TimelineRing::TimelineRing(size_t events) {
+  // One slot more than asked for: the slot being written is never reported
+  size_t capacity = 2;
+  while (capacity < events + 1) capacity <<= 1;
+  slots_ = std::make_unique<Slot[]>(capacity);
+  mask_ = capacity - 1;
+}
+
+void TimelineRing::push(const TimelineEvent &e) {
+  uint64_t n = written_.load(std::memory_order_relaxed);
+  Slot &s = slots_[n & mask_];
+  s.ns.store(e.ns, std::memory_order_relaxed);
+  s.tick_pid.store((static_cast<uint64_t>(e.tick) << 32) | e.pid, std::memory_order_relaxed);
+  s.cpu_kind.store((static_cast<uint32_t>(e.cpu) << 8) | static_cast<uint32_t>(e.kind), std::memory_order_relaxed);
+  written_.store(n + 1, std::memory_order_release);
+}
+
+std::vector<TimelineEvent> TimelineRing::snapshot() const {
+  const uint64_t capacity = mask_ + 1;
+  uint64_t end = written_.load(std::memory_order_acquire);
+  uint64_t begin = end >= capacity ? end - capacity + 1 : 0;
+
+  std::vector<TimelineEvent> out;
+  out.reserve(end - begin);
+  for (uint64_t i = begin; i < end; ++i) {
+    const Slot &s = slots_[i & mask_];
+    uint64_t tick_pid = s.tick_pid.load(std::memory_order_relaxed);
+    uint32_t cpu_kind = s.cpu_kind.load(std::memory_order_relaxed);
+    out.push_back({s.ns.load(std::memory_order_relaxed), static_cast<uint32_t>(tick_pid >> 32),
+                   static_cast<uint32_t>(tick_pid), static_cast<uint16_t>(cpu_kind >> 8),
+                   static_cast<TimelineKind>(cpu_kind & 0xff)});
+  }
+
+  // Whatever the writer reached meanwhile (plus the slot it may be filling)
+  // could have been overwritten under us
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t now = written_.load(std::memory_order_relaxed);
+  uint64_t valid = now >= capacity ? now - capacity + 1 : 0;
+  if (valid > begin) out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(std::min(valid - begin, out.size())));
+  return out;
+}
+
+// === Timeline ===
+
+Timeline::Timeline(uint32_t cores, size_t events_per_thread)
+    : cores_(cores), origin_(std::chrono::steady_clock::now()) {
+  for (uint32_t i = 0; i <= cores; ++i) rings_.push_back(std::make_unique<TimelineRing>(events_per_thread));
+}
+
+uint64_t Timeline::recorded() const {
+  uint64_t total = 0;
+  for (const auto &ring : rings_) total += ring->written();
+  return total;
+}
+
+std::vector<TimelineEvent> Timeline::events() const {
+  std::vector<TimelineEvent> out;
+  for (const auto &ring : rings_) {
+    std::vector<TimelineEvent> part = ring->snapshot();
+    out.insert(out.end(), part.begin(), part.end());
+  }
+  std::stable_sort(out.begin(), out.end(),
+                   [](const TimelineEvent &a, const TimelineEvent &b) { return a.ns < b.ns; });
+  return out;
+}
+
+const char *timeline_phase_name(TimelinePhase phase) {
+  static const char *const kNames[] = {"housekeeping", "timers", "preemption", "admission",
+                                       "dispatch", "execute", "log", "advance", "idle"};
+  auto i = static_cast<size_t>(phase);
+  return i < std::size(kNames) ? kNames[i] : "?";
+}
+
+// === Chrome Trace Export ===
+// Core c is thread 1 + c of process 1, the scheduler is thread 0.
+// Timestamps are microseconds.
+
+namespace {
+
+class TraceWriter {
+public:
+  explicit TraceWriter(std::ostringstream &out) : out_(out) { out_ << std::fixed << std::setprecision(3); }
+
+  void thread_name(uint32_t tid, const std::string &name) {
+    begin();
+    out_ << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+         << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << name << "\"}}";
+    begin();
+    out_ << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+         << ",\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":" << tid << "}}";
+  }
+
+  void slice(uint32_t tid, const std::string &name, uint64_t from_ns, uint64_t to_ns,
+             uint32_t tick, const char *end = nullptr) {
+    begin();
+    out_ << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"name\":\"" << name
+         << "\",\"ts\":" << from_ns / 1000.0 << ",\"dur\":" << (to_ns - from_ns) / 1000.0
+         << ",\"args\":{\"tick\":" << tick;
+    if (end) out_ << ",\"end\":\"" << end << "\"";
+    out_ << "}}";
+    ++events_;
+  }
+
+  void instant(uint32_t tid, const std::string &name, uint64_t ns, uint32_t tick, uint32_t pid) {
+    begin();
+    out_ << "{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << tid << ",\"name\":\"" << name
+         << "\",\"ts\":" << ns / 1000.0 << ",\"args\":{\"tick\":" << tick << ",\"pid\":" << pid << "}}";
+    ++events_;
+  }
+
+  uint64_t events() const { return events_; }
+
+private:
+  void begin() {
+    if (!first_) out_ << ",\n";
+    first_ = false;
+  }
+  std::ostringstream &out_;
+  bool first_{true};
+  uint64_t events_{0};
+};
+
+struct OpenSlice {
+  bool open{false};
+  uint64_t ns{0};
+  uint32_t tick{0};
+  uint32_t pid{0};          // TimelinePhase on the scheduler track
+};
+
+} // namespace
+
+std::string chrome_trace_json(const Timeline &timeline, uint64_t *trace_events) {
+  std::vector<TimelineEvent> events = timeline.events();
+  const uint32_t cores = timeline.cores();
+
+  std::ostringstream oss;
+  oss << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  TraceWriter w(oss);
+  w.thread_name(0, "scheduler");
+  for (uint32_t cpu = 0; cpu < cores; ++cpu) w.thread_name(1 + cpu, "CPU " + std::to_string(cpu));
+
+  std::vector<OpenSlice> running(cores);
+  OpenSlice phase;
+  auto process = [](uint32_t pid) { return "pid " + std::to_string(pid); };
+
+  for (const TimelineEvent &e : events) {
+    if (e.kind != TimelineKind::PHASE && e.kind != TimelineKind::WAKE && e.cpu >= cores) continue;
+    switch (e.kind) {
+    case TimelineKind::PHASE:
+      if (phase.open)
+        w.slice(0, timeline_phase_name(static_cast<TimelinePhase>(phase.pid)), phase.ns, e.ns, phase.tick);
+      phase = {true, e.ns, e.tick, e.pid};
+      break;
+    case TimelineKind::DISPATCH: {
+      OpenSlice &r = running[e.cpu];
+      if (r.open) w.slice(1 + e.cpu, process(r.pid), r.ns, e.ns, r.tick, "unknown");
+      r = {true, e.ns, e.tick, e.pid};
+      break;
+    }
+    case TimelineKind::PREEMPT:
+    case TimelineKind::SLEEP:
+    case TimelineKind::FINISH: {
+      // The dispatch may have been overwritten in the ring; drop the tail
+      OpenSlice &r = running[e.cpu];
+      if (!r.open || r.pid != e.pid) break;
+      const char *end = e.kind == TimelineKind::PREEMPT ? "preempt"
+                        : e.kind == TimelineKind::SLEEP ? "sleep" : "finish";
+      w.slice(1 + e.cpu, process(r.pid), r.ns, e.ns, r.tick, end);
+      r.open = false;
+      break;
+    }
+    case TimelineKind::WAKE:
+      w.instant(0, "wake " + process(e.pid), e.ns, e.tick, e.pid);
+      break;
+    case TimelineKind::YIELD:
+      w.instant(1 + e.cpu, "yield", e.ns, e.tick, e.pid);
+      break;
+    }
+  }
+
+  // Still running when the dump was taken
+  uint64_t last = events.empty() ? 0 : events.back().ns;
+  for (uint32_t cpu = 0; cpu < cores; ++cpu)
+    if (running[cpu].open) w.slice(1 + cpu, process(running[cpu].pid), running[cpu].ns, last, running[cpu].tick, "running");
+  if (phase.open)
+    w.slice(0, timeline_phase_name(static_cast<TimelinePhase>(phase.pid)), phase.ns, last, phase.tick);
+
+  oss << "\n]}\n";
+  if (trace_events) *trace_events = w.events();
+  return oss.str();
+}
+
+int64_t write_chrome_trace(const Timeline &timeline, const std::string &path) {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out) return -1;
+  uint64_t written = 0;
+  out << chrome_trace_json(timeline, &written);
+  out.flush();
+  return out ? static_cast<int64_t>(written) : -1;
+}
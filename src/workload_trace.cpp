@@ -0,0 +1,339 @@
+#include "../include/workload_trace.hpp"
+#include "../include/process.hpp"
+#include "../include/scheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+static constexpr size_t kReadAhead = 1024;        // parsed records queued ahead of the clock
+
+// === Program Text ===
+
+static const char *const kOpNames[] = {"PRINT", "DECLARE", "ADD", "SUBTRACT", "SLEEP", "FOR"};
+
+// Recursive-descent parser over one program string
+struct ProgramParser {
+  const std::string &s;
+  size_t pos{0};
+  std::string error;
+
+  void skip_ws() {
+    while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) ++pos;
+  }
+  bool fail(const std::string &why) {
+    if (error.empty()) error = why + " at column " + std::to_string(pos + 1);
+    return false;
+  }
+  bool expect(char c) {
+    skip_ws();
+    if (pos < s.size() && s[pos] == c) { ++pos; return true; }
+    return fail(std::string("expected '") + c + "'");
+  }
+
+  bool arg(std::string &out) {
+    skip_ws();
+    if (pos < s.size() && s[pos] == '"') {
+      for (++pos; pos < s.size() && s[pos] != '"'; ++pos) {
+        if (s[pos] == '\\' && pos + 1 < s.size()) ++pos;
+        out += s[pos];
+      }
+      return pos < s.size() ? (++pos, true) : fail("unterminated string");
+    }
+    size_t start = pos;
+    while (pos < s.size() && s[pos] != ',' && s[pos] != ')') ++pos;
+    out = s.substr(start, pos - start);
+    while (!out.empty() && std::isspace(static_cast<unsigned char>(out.back()))) out.pop_back();
+    return true;
+  }
+
+  bool instruction(Instruction &ins, int depth) {
+    skip_ws();
+    size_t start = pos;
+    while (pos < s.size() && std::isalpha(static_cast<unsigned char>(s[pos]))) ++pos;
+    std::string op = s.substr(start, pos - start);
+    std::transform(op.begin(), op.end(), op.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    auto it = std::find(std::begin(kOpNames), std::end(kOpNames), op);
+    if (it == std::end(kOpNames)) return fail(op.empty() ? "expected an instruction" : "unknown instruction " + op);
+    ins.type = static_cast<InstructionType>(it - std::begin(kOpNames));
+
+    skip_ws();
+    if (pos < s.size() && s[pos] == '(') {
+      ++pos;
+      skip_ws();
+      if (pos < s.size() && s[pos] == ')') {
+        ++pos;
+      } else {
+        for (;;) {
+          ins.args.emplace_back();
+          if (!arg(ins.args.back())) return false;
+          skip_ws();
+          if (pos >= s.size() || s[pos] != ',') break;
+          ++pos;
+        }
+        if (!expect(')')) return false;
+      }
+    }
+
+    if (ins.type != InstructionType::FOR) return true;
+    if (ins.args.empty() || ins.args[0].empty() ||
+        !std::all_of(ins.args[0].begin(), ins.args[0].end(), [](unsigned char c) { return std::isdigit(c); }))
+      return fail("FOR needs a repeat count");
+    if (depth >= FOR_MAX_NESTING) return fail("FOR nested deeper than " + std::to_string(FOR_MAX_NESTING));
+    return expect('{') && list(ins.nested, depth + 1, '}') && expect('}');
+  }
+
+  // Instructions separated by ';' up to `end` (0 = end of string)
+  bool list(std::vector<Instruction> &out, int depth, char end) {
+    for (;;) {
+      skip_ws();
+      if (pos >= s.size() || s[pos] == end) return true;
+      out.emplace_back();
+      if (!instruction(out.back(), depth)) return false;
+      skip_ws();
+      if (pos < s.size() && s[pos] == ';') ++pos;
+      else if (pos < s.size() && s[pos] != end) return fail("expected ';'");
+    }
+  }
+};
+
+bool parse_program(const std::string &text, std::vector<Instruction> &out, std::string &error) {
+  ProgramParser p{text};
+  out.clear();
+  if (p.list(out, 0, 0)) return true;
+  error = p.error;
+  return false;
+}
+
+static void format_into(std::ostringstream &oss, const std::vector<Instruction> &ins) {
+  for (size_t i = 0; i < ins.size(); ++i) {
+    const Instruction &in = ins[i];
+    if (i) oss << "; ";
+    oss << kOpNames[static_cast<size_t>(in.type) % 6];
+    if (!in.args.empty()) {
+      oss << "(";
+      for (size_t a = 0; a < in.args.size(); ++a) {
+        const std::string &arg = in.args[a];
+        bool quote = arg.empty() || arg.find_first_of(",;(){}\" \t") != std::string::npos;
+        if (a) oss << ", ";
+        if (!quote) { oss << arg; continue; }
+        oss << '"';
+        for (char c : arg) oss << (c == '"' || c == '\\' ? "\\" : "") << c;
+        oss << '"';
+      }
+      oss << ")";
+    }
+    if (in.type == InstructionType::FOR) {
+      oss << "{";
+      format_into(oss, in.nested);
+      oss << "}";
+    }
+  }
+}
+
+std::string format_program(const std::vector<Instruction> &ins) {
+  std::ostringstream oss;
+  format_into(oss, ins);
+  return oss.str();
+}
+
+// === Reader ===
+
+bool WorkloadTraceReader::open(const std::string &path, std::string &error) {
+  in_.open(path);
+  if (!in_) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::error_code ec;
+  file_size_ = std::filesystem::file_size(path, ec);
+  if (ec) file_size_ = 0;
+  return true;
+}
+
+void WorkloadTraceReader::reject(const std::string &why) {
+  if (bad_lines_++ == 0) first_error_ = "line " + std::to_string(line_no_) + ": " + why;
+}
+
+bool WorkloadTraceReader::next(WorkloadRecord &out) {
+  std::string line;
+  while (std::getline(in_, line)) {
+    ++line_no_;
+    bytes_read_ += line.size() + 1;
+    std::istringstream iss(line);
+    std::string first;
+    if (!(iss >> first) || first[0] == '#') continue;
+
+    std::string rest;
+    if (first == "program") {
+      std::string ref;
+      iss >> ref;
+      std::getline(iss, rest);
+      auto image = std::make_shared<std::vector<Instruction>>();
+      std::string error;
+      if (ref.empty()) reject("program needs a name");
+      else if (!parse_program(rest, *image, error)) reject(error);
+      else images_[ref] = std::move(image);
+      continue;
+    }
+
+    WorkloadRecord rec;
+    std::string priority;
+    iss >> rec.name >> priority;
+    std::getline(iss, rest);
+    try {
+      rec.tick = static_cast<uint32_t>(std::stoul(first));
+      rec.priority = static_cast<uint32_t>(std::stoul(priority));
+    } catch (...) {
+      reject("expected <tick> <name> <priority> <program>");
+      continue;
+    }
+    if (rec.tick < last_tick_) {
+      reject("tick " + std::to_string(rec.tick) + " before " + std::to_string(last_tick_));
+      continue;
+    }
+
+    size_t at = rest.find_first_not_of(" \t");
+    if (at != std::string::npos && rest[at] == '@') {
+      std::string ref = rest.substr(at + 1);
+      ref.erase(ref.find_last_not_of(" \t\r") + 1);
+      auto it = images_.find(ref);
+      if (it == images_.end()) {
+        reject("unknown program " + ref);
+        continue;
+      }
+      rec.program = it->second;
+    } else {
+      auto program = std::make_shared<std::vector<Instruction>>();
+      std::string error;
+      if (!parse_program(rest, *program, error)) {
+        reject(error);
+        continue;
+      }
+      rec.program = std::move(program);
+    }
+    last_tick_ = rec.tick;
+    out = std::move(rec);
+    return true;
+  }
+  return false;
+}
+
+// === Replay ===
+
+WorkloadReplay::WorkloadReplay(Scheduler &sched, const Config &cfg)
+    : sched_(sched), group_id_(sched.group_id(cfg.generator_group)) {}
+
+WorkloadReplay::~WorkloadReplay() { stop(); }
+
+bool WorkloadReplay::start(const std::string &path, std::string &error) {
+  if (running_.load() || !reader_.open(path, error)) return false;
+  path_ = path;
+  file_size_ = reader_.file_size();
+  running_ = true;
+  thread_ = std::thread(&WorkloadReplay::read_loop, this);
+  sched_.set_tick_hook([this](uint32_t tick) { on_tick(tick); });
+  return true;
+}
+
+void WorkloadReplay::stop() {
+  {
+    std::lock_guard<std::mutex> lock(queue_mtx_);
+    if (!running_.exchange(false)) return;
+  }
+  queue_cv_.notify_all();
+  sched_.set_tick_hook(nullptr); // returns once no tick is using the hook
+  if (thread_.joinable()) thread_.join();
+}
+
+// Parses ahead of the clock, at most kReadAhead records
+void WorkloadReplay::read_loop() {
+  while (running_.load()) {
+    WorkloadRecord rec;
+    bool more = reader_.next(rec);
+    std::unique_lock<std::mutex> lock(queue_mtx_);
+    bytes_read_ = reader_.bytes_read();
+    bad_lines_ = reader_.bad_lines();
+    if (first_error_.empty()) first_error_ = reader_.first_error();
+    if (!more) {
+      eof_ = true;
+      queue_cv_.notify_all();
+      return;
+    }
+    queue_cv_.wait(lock, [&] { return queue_.size() < kReadAhead || !running_.load(); });
+    if (!running_.load()) return;
+    queue_.push_back(std::move(rec));
+    queue_cv_.notify_all();
+  }
+}
+
+// Submits every record due by this tick. Runs before admission, so a record
+// for trace tick t is admitted on the t-th tick of the replay. If the reader
+// is behind, the tick waits for it rather than let arrivals slip.
+void WorkloadReplay::on_tick(uint32_t tick) {
+  if (!started_) {
+    started_ = true;
+    first_tick_ = tick;
+  }
+  const uint32_t now = tick - first_tick_;
+  trace_tick_.store(now);
+
+  for (;;) {
+    WorkloadRecord rec;
+    {
+      std::unique_lock<std::mutex> lock(queue_mtx_);
+      if (queue_.empty() && !eof_) {
+        stalls_.fetch_add(1);
+        queue_cv_.wait(lock, [&] { return !queue_.empty() || eof_ || !running_.load(); });
+      }
+      if (queue_.empty()) {
+        if (eof_) done_ = true;
+        return;
+      }
+      if (queue_.front().tick > now) return;
+      rec = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    queue_cv_.notify_all();
+
+    auto p = std::make_shared<Process>(sched_.next_replay_pid(), rec.name, *rec.program);
+    p->priority = rec.priority;
+    p->deadline = rec.deadline;
+    p->group_id = group_id_;
+    sched_.submit_process(std::move(p));
+    submitted_.fetch_add(1);
+    last_arrival_tick_.store(rec.tick);
+  }
+}
+
+WorkloadReplayStatus WorkloadReplay::status() const {
+  WorkloadReplayStatus s;
+  s.path = path_;
+  s.running = running_.load();
+  s.done = done_.load();
+  s.submitted = submitted_.load();
+  s.trace_tick = trace_tick_.load();
+  s.last_arrival_tick = last_arrival_tick_.load();
+  s.stalls = stalls_.load();
+  s.file_size = file_size_;
+  std::lock_guard<std::mutex> lock(queue_mtx_);
+  s.bytes_read = bytes_read_;
+  s.bad_lines = bad_lines_;
+  s.first_error = first_error_;
+  return s;
+}
+
+std::string workload_replay_report(const WorkloadReplayStatus &s) {
+  std::ostringstream oss;
+  const char *state = s.done ? "finished" : s.running ? "running" : "stopped";
+  oss << "Trace replay " << s.path << ": " << state << ", " << s.submitted << " arrivals submitted"
+      << ", trace tick " << s.trace_tick << " (last arrival at " << s.last_arrival_tick << ")\n";
+  oss << std::fixed << std::setprecision(1) << "  read " << s.bytes_read << "/" << s.file_size << " bytes";
+  if (s.file_size > 0) oss << " (" << 100.0 * static_cast<double>(s.bytes_read) / s.file_size << "%)";
+  oss << ", " << s.stalls << " ticks waited for the reader\n";
+  if (s.bad_lines > 0)
+    oss << "  skipped " << s.bad_lines << " malformed lines, first at " << s.first_error << "\n";
+  return oss.str();
+}
@@ -4,6 +4,9 @@
 #include "../include/scheduler.hpp"
 #include <cassert>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
 #include <iostream>
 #include <thread>
 
@@ -202,6 +205,178 @@ int main() {
   //     std::cout << "Test 10 passed: Scheduler received generated process.\n";
   //   }
 
+  // === Test 11: same seed, same programs ===
+  {
+    Config cfg11;
+    cfg11.seed = 42;
+    Scheduler sched11(cfg11);
+    ProcessGenerator a(cfg11, sched11), b(cfg11, sched11);
+    uint32_t est_a = 0, est_b = 0;
+    for (int round = 0; round < 5; ++round) {
+      auto ia = a.generate_instructions(20, est_a);
+      auto ib = b.generate_instructions(20, est_b);
+      assert(ia.size() == ib.size() && est_a == est_b);
+      for (size_t i = 0; i < ia.size(); ++i)
+        assert(ia[i].type == ib[i].type && ia[i].args == ib[i].args);
+    }
+    std::cout << "Test 11 passed: seeded generators are reproducible.\n";
+  }
+
+  // === Test 12: workload profiles from config ===
+  {
+    const char *path = "/tmp/csopesy_test_profiles.txt";
+    {
+      std::ofstream out(path);
+      out << "workload printy\n"
+          << "profile.printy.mix print-heavy\n"
+          << "profile.printy.for-depth 0\n"
+          << "profile.printy.ins pareto\n"
+          << "profile.printy.min-ins 2\n"
+          << "profile.printy.max-ins 500\n"
+          << "profile.burst.arrival bursty\n"
+          << "profile.burst.batch 3\n"
+          << "profile.burst.for-repeats 2,4\n";
+    }
+    Config cfg12 = load_config(path);
+    std::remove(path);
+    assert(cfg12.profiles.size() == 2 && cfg12.workload == "printy");
+    WorkloadProfile w = active_workload(cfg12);
+    assert(w.name == "printy" && w.mix[0] == 6 && w.for_depth == 0 && w.max_ins == 500);
+    assert(cfg12.profiles[1].batch == 3 && cfg12.profiles[1].for_min_repeats == 2 &&
+           cfg12.profiles[1].for_max_repeats == 4);
+
+    cfg12.seed = 3;
+    cfg12.max_unrolled_instructions = 0;
+    Scheduler sched12(cfg12);
+    ProcessGenerator gen12(cfg12, sched12);
+    uint32_t est = 0, prints = 0;
+    auto ins = gen12.generate_instructions(1000, est);
+    for (const auto &i : ins) {
+      assert(i.type != InstructionType::FOR);
+      prints += i.type == InstructionType::PRINT;
+    }
+    assert(prints > 400); // 6 of 11 weight units
+    std::cout << "Test 12 passed: workload profile mix and FOR depth applied.\n";
+
+    // Bursty arrivals of 3 processes per event, on the scheduler clock
+    cfg12.workload = "burst";
+    cfg12.num_cpu = 1;
+    cfg12.min_ins = cfg12.max_ins = 2;
+    cfg12.scheduler_tick_delay = 0;
+    Scheduler sched13(cfg12);
+    std::map<uint32_t, uint32_t> per_tick;
+    std::mutex per_tick_mtx;
+    sched13.set_trace_hook([&](TraceKind kind, uint32_t tick, const Process &, uint32_t) {
+      std::lock_guard<std::mutex> lock(per_tick_mtx);
+      if (kind == TraceKind::ARRIVAL) per_tick[tick]++;
+    });
+    ProcessGenerator gen13(cfg12, sched13);
+    sched13.start();
+    gen13.start();
+    while (sched13.current_tick() < 200) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    gen13.stop();
+    sched13.stop();
+    uint32_t events = 0;
+    for (const auto &[tick, n] : per_tick) {
+      assert(n % 3 == 0);
+      events += n / 3;
+    }
+    assert(events >= 8 && per_tick.size() < 200);
+    std::cout << "Test 13 passed: bursty arrivals in batches.\n";
+  }
+
+  // === Test 14: unseeded arrivals follow the scheduler clock ===
+  {
+    Config cfg14;
+    cfg14.num_cpu = 1;
+    cfg14.batch_process_freq = 4;
+    cfg14.min_ins = cfg14.max_ins = 2;
+    cfg14.scheduler_tick_delay = 0;
+    Scheduler sched14(cfg14);
+    std::vector<std::pair<uint32_t, uint32_t>> arrivals; // tick, pid
+    std::mutex arrivals_mtx;
+    sched14.set_trace_hook([&](TraceKind kind, uint32_t tick, const Process &p, uint32_t) {
+      std::lock_guard<std::mutex> lock(arrivals_mtx);
+      if (kind == TraceKind::ARRIVAL) arrivals.emplace_back(tick, p.id());
+    });
+    ProcessGenerator gen14(cfg14, sched14);
+    sched14.start();
+    gen14.start();
+    while (sched14.current_tick() < 100) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    gen14.stop();
+    sched14.stop();
+    assert(arrivals.size() >= 20);
+    for (size_t i = 1; i < arrivals.size(); ++i) {
+      assert(arrivals[i].first - arrivals[i - 1].first == 4);
+      assert(arrivals[i].second == arrivals[i - 1].second + 1);
+    }
+    std::cout << "Test 14 passed: one arrival every 4 ticks, in id order.\n";
+  }
+
+  // === Test 15: priority weights are clamped to the priority range ===
+  {
+    const char *path = "/tmp/csopesy_test_weights.txt";
+    {
+      std::ofstream out(path);
+      out << "priority-weights 1,1,1,1,50\n"
+          << "min-priority 1\n"
+          << "max-priority 3\n";
+    }
+    Config cfg15 = load_config(path);
+    std::remove(path);
+    assert((cfg15.priority_weights == std::vector<uint32_t>{1, 1, 1}));
+
+    cfg15.num_cpu = 1;
+    cfg15.batch_process_freq = 1;
+    cfg15.min_ins = cfg15.max_ins = 1;
+    cfg15.scheduler_tick_delay = 0;
+    Scheduler sched15(cfg15);
+    std::vector<uint32_t> priorities;
+    std::mutex priorities_mtx;
+    sched15.set_trace_hook([&](TraceKind kind, uint32_t, const Process &p, uint32_t) {
+      std::lock_guard<std::mutex> lock(priorities_mtx);
+      if (kind == TraceKind::ARRIVAL) priorities.push_back(p.priority);
+    });
+    ProcessGenerator gen15(cfg15, sched15);
+    sched15.start();
+    gen15.start();
+    while (sched15.current_tick() < 100) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    gen15.stop();
+    sched15.stop();
+    assert(priorities.size() >= 50);
+    for (uint32_t prio : priorities) assert(prio >= 1 && prio <= 3);
+    std::cout << "Test 15 passed: priority weights clamped to max-priority.\n";
+  }
+
+  // === Test 16: poisson arrivals with batch-process-freq 0 ===
+  {
+    Config cfg16;
+    cfg16.num_cpu = 1;
+    cfg16.batch_process_freq = 0;
+    cfg16.min_ins = cfg16.max_ins = 1;
+    cfg16.scheduler_tick_delay = 0;
+    cfg16.seed = 16;
+    WorkloadProfile p16;
+    p16.name = "p";
+    p16.arrival = "poisson";
+    cfg16.profiles.push_back(p16);
+    cfg16.workload = "p";
+    Scheduler sched16(cfg16);
+    std::atomic<uint32_t> arrivals{0};
+    sched16.set_trace_hook([&](TraceKind kind, uint32_t, const Process &, uint32_t) {
+      if (kind == TraceKind::ARRIVAL) arrivals.fetch_add(1);
+    });
+    ProcessGenerator gen16(cfg16, sched16);
+    sched16.start();
+    gen16.start();
+    while (sched16.current_tick() < 50) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    gen16.stop();
+    sched16.stop();
+    // Mean gap of one tick: about one arrival per tick, not an endless burst
+    assert(arrivals.load() > 0 && arrivals.load() < 500);
+    std::cout << "Test 16 passed: poisson arrivals with a zero interval terminate.\n";
+  }
+
   std::cout << "All generator tests passed successfully.\n";
   return 0;
 }
@@ -1,11 +1,17 @@
 #include "../include/scheduler.hpp"
+#include "../include/cli.hpp"
 #include "../include/config.hpp"
 #include "../include/process.hpp"
 #include "../include/cpu_worker.hpp"
+#include "../include/process_generator.hpp"
+#include "../include/workload_trace.hpp"
+#include "../include/sweep.hpp"
+#include "../include/shadow.hpp"
 #include <thread>
 #include <chrono>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 
 void test_scheduler_algo(bool use_rr)
 {
@@ -228,6 +234,1139 @@ void test_sleep(){
   std::cout << "Scheduler stopped safely.\n";
 }
 
+void test_priority_aging()
+{
+  auto low = std::make_shared<Process>(1, "low", std::vector<Instruction>{{InstructionType::PRINT, {"low"}}});
+  auto high = std::make_shared<Process>(2, "high", std::vector<Instruction>{{InstructionType::PRINT, {"high"}}});
+  low->priority = 0;
+  low->ready_tick = 0;   // has been waiting since tick 0
+  high->priority = 2;
+  high->ready_tick = 30; // just arrived at tick 30
+
+  // Without aging the higher base priority always wins
+  DynamicVictimChannel plain(SchedulingPolicy::PRIORITY);
+  plain.send(low);
+  plain.send(high);
+  assert(plain.receiveNext()->id() == high->id());
+
+  // With +1 per 10 ticks, low has aged to 3 by tick 30 and overtakes high
+  DynamicVictimChannel aged(SchedulingPolicy::PRIORITY, 10);
+  aged.send(high);
+  aged.send(low);
+  assert(effective_priority(*low, 30, 10) == 3);
+  assert(effective_priority(*high, 30, 10) == 2);
+  assert(aged.peekNext()->id() == low->id());
+  assert(aged.receiveVictim()->id() == high->id());
+
+  std::cout << "Scheduler test PRIORITY aging passed.\n";
+}
+
+// max_cpu > num_cpu adds offline core slots, which preemption must skip
+void test_priority_preemption(uint32_t max_cpu = 0)
+{
+  std::vector<Instruction> long_job(500, {InstructionType::PRINT, {"L"}});
+  std::vector<Instruction> short_job(3, {InstructionType::PRINT, {"H"}});
+  auto low = std::make_shared<Process>(1, "low", long_job);
+  auto high = std::make_shared<Process>(2, "high", short_job);
+  low->priority = 0;
+  high->priority = 5;
+
+  Config cfg;
+  cfg.num_cpu = 1;
+  cfg.max_cpu = max_cpu;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::PRIORITY;
+  cfg.priority_preempt = true;
+  Scheduler sched(cfg);
+
+  sched.submit_process(low);
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  sched.submit_process(high);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sched.pause();
+
+  // high must have displaced low instead of waiting for its 500 instructions
+  assert(high->get_logs().size() == 3);
+  assert(low->get_executed_instructions() < 500);
+  assert(low->ticks_waited > 0 || low->is_running());
+
+  std::cout << "Scheduler test PRIORITY preemption" << (max_cpu ? " (spare core slots)" : "") << " passed.\n";
+  sched.stop();
+}
+
+void test_mlfq(uint32_t max_cpu = 0)
+{
+  std::vector<Instruction> long_job(400, {InstructionType::PRINT, {"L"}});
+  std::vector<Instruction> short_job(3, {InstructionType::PRINT, {"S"}});
+  auto batch = std::make_shared<Process>(1, "batch", long_job);
+  auto interactive = std::make_shared<Process>(2, "interactive", short_job);
+
+  Config cfg;
+  cfg.num_cpu = 1;
+  cfg.max_cpu = max_cpu;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::MLFQ;
+  cfg.mlfq_levels = 3;
+  cfg.mlfq_quanta = {2, 4};   // level 2 gets 8 by doubling
+  cfg.mlfq_boost_ticks = 0;   // no boost: batch must stay demoted
+  Scheduler sched(cfg);
+
+  sched.submit_process(batch);
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  sched.submit_process(interactive);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sched.pause();
+
+  // batch used up its level 0 and level 1 quanta, so the new arrival on
+  // level 0 preempts it and finishes long before batch does
+  assert(batch->mlfq_level == 2);
+  assert(interactive->get_logs().size() == 3);
+  assert(interactive->mlfq_level <= 1); // 3 instructions span one demotion
+  assert(batch->get_executed_instructions() < 400);
+  assert(sched.mlfq_queue_lengths().size() == 3);
+
+  std::cout << "Scheduler test MLFQ" << (max_cpu ? " (spare core slots)" : "") << " passed.\n";
+  sched.stop();
+}
+
+void test_cfs()
+{
+  // Ordered by vruntime: leftmost runs next, rightmost is the victim
+  DynamicVictimChannel dvc(SchedulingPolicy::CFS);
+  for (uint32_t i = 1; i <= 3; ++i) {
+    auto p = std::make_shared<Process>(i, "v" + std::to_string(i), std::vector<Instruction>{});
+    p->vruntime = 1000 * (4 - i);
+    dvc.send(p);
+  }
+  assert(dvc.receiveNext()->id() == 3);
+  assert(dvc.receiveVictim()->id() == 1);
+  assert(cfs_weight(0) == 1024);
+  assert(cfs_vruntime_delta(5) < cfs_vruntime_delta(0));
+
+  // Weighted sharing: priority 5 (weight 3121) vs priority 0 (weight 1024)
+  std::vector<Instruction> work(2000, {InstructionType::PRINT, {"W"}});
+  auto heavy = std::make_shared<Process>(1, "heavy", work);
+  auto light = std::make_shared<Process>(2, "light", work);
+  heavy->priority = 5;
+  light->priority = 0;
+
+  Config cfg;
+  cfg.num_cpu = 1;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::CFS;
+  cfg.cfs_min_granularity = 2;
+  Scheduler sched(cfg);
+
+  sched.submit_process(light);
+  sched.submit_process(heavy);
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  sched.pause();
+
+  uint32_t h = heavy->get_executed_instructions();
+  uint32_t l = light->get_executed_instructions();
+  std::cout << "CFS share heavy=" << h << " light=" << l << "\n";
+  assert(l > 0);
+  assert(h > 2 * l); // ~3x expected from the weight ratio
+
+  std::cout << "Scheduler test CFS passed.\n";
+  sched.stop();
+}
+
+void test_edf(uint32_t max_cpu = 0)
+{
+  std::vector<Instruction> long_job(300, {InstructionType::PRINT, {"L"}});
+  std::vector<Instruction> urgent_job(5, {InstructionType::PRINT, {"U"}});
+  auto background = std::make_shared<Process>(1, "background", long_job);
+  auto urgent = std::make_shared<Process>(2, "urgent", urgent_job);
+  auto hopeless = std::make_shared<Process>(3, "hopeless", long_job);
+  urgent->deadline = 20;   // 5 instructions fit easily
+  hopeless->deadline = 10; // 300 instructions never fit in 10 ticks
+
+  Config cfg;
+  cfg.num_cpu = 1;
+  cfg.max_cpu = max_cpu;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::EDF;
+  assert(set_config_key(cfg, "deadline-admission", "Reject"));
+  assert(cfg.deadline_admission == DeadlineAdmission::REJECT);
+  bool typo_refused = false;
+  try { set_config_key(cfg, "deadline-admission", "rejct"); } catch (const std::invalid_argument &) { typo_refused = true; }
+  assert(typo_refused && cfg.deadline_admission == DeadlineAdmission::REJECT);
+  Scheduler sched(cfg);
+
+  sched.submit_process(background);
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  sched.submit_process(urgent);
+  sched.submit_process(hopeless);
+  std::this_thread::sleep_for(std::chrono::milliseconds(80));
+  sched.pause();
+
+  DeadlineSummary summary = sched.deadline_summary();
+  assert(summary.rejected == 1);
+  assert(hopeless->get_executed_instructions() == 0);
+  assert(urgent->get_logs().size() == 5);
+  assert(summary.met == 1 && summary.missed == 0);
+  assert(background->get_executed_instructions() < 300);
+  assert(!sched.deadline_report().empty());
+
+  std::cout << "Scheduler test EDF" << (max_cpu ? " (spare core slots)" : "") << " passed.\n";
+  sched.stop();
+}
+
+void test_cpu_groups()
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::FCFS;
+  cfg.groups = {{"batch", 1, 50}, {"interactive", 1, 0}};
+  cfg.group_period = 10; // batch may use 10 of every 20 core-ticks
+  Scheduler sched(cfg);
+  assert(sched.group_id("batch") == 1);
+  assert(sched.group_id("unknown") == 0);
+
+  std::vector<Instruction> long_job(1000, {InstructionType::PRINT, {"B"}});
+  for (uint32_t i = 1; i <= 4; ++i) {
+    auto p = std::make_shared<Process>(i, "b" + std::to_string(i), long_job);
+    p->group_id = sched.group_id("batch");
+    sched.submit_process(p);
+  }
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // Interactive work still gets a core while batch is saturated
+  auto shell = std::make_shared<Process>(9, "shell", std::vector<Instruction>(5, {InstructionType::PRINT, {"I"}}));
+  shell->group_id = sched.group_id("interactive");
+  sched.submit_process(shell);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sched.pause();
+
+  auto usage = sched.group_usage();
+  uint64_t capacity = static_cast<uint64_t>(sched.current_tick()) * cfg.num_cpu;
+  std::cout << "Group batch used " << usage[1].used_total << " of " << capacity
+            << " core-ticks, throttled " << usage[1].throttled_ticks << "\n";
+  uint64_t periods = sched.current_tick() / cfg.group_period + 1;
+  assert(usage[1].used_total <= periods * 10); // never more than the quota per period
+  assert(usage[1].throttled_ticks > 0);
+  assert(shell->get_logs().size() == 5);
+  assert(!sched.group_report().empty());
+
+  std::cout << "Scheduler test CPU groups passed.\n";
+  sched.stop();
+}
+
+void test_group_share_cap_idle()
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::FCFS;
+  cfg.groups = {{"batch", 1, 0}, {"interactive", 1, 0}}; // one core each while both wait
+  cfg.group_period = 100000;                             // no rollover during the test
+  Scheduler sched(cfg);
+
+  // b2 is parked by batch's share cap while the shell waits for a core
+  std::vector<Instruction> long_job(1000, {InstructionType::PRINT, {"B"}});
+  auto b1 = std::make_shared<Process>(1, "b1", long_job);
+  auto b2 = std::make_shared<Process>(2, "b2", long_job);
+  auto shell = std::make_shared<Process>(3, "shell", std::vector<Instruction>(5, {InstructionType::PRINT, {"I"}}));
+  b1->group_id = b2->group_id = sched.group_id("batch");
+  shell->group_id = sched.group_id("interactive");
+  sched.submit_process(b1);
+  sched.submit_process(b2);
+  sched.submit_process(shell);
+  sched.start();
+  while (sched.finished_count() < 1) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  sched.pause();
+
+  // Once the shell is done nobody else waits, so b2 takes the idle core
+  auto usage = sched.group_usage();
+  assert(usage[1].parked == 0 && usage[1].running == 2);
+  assert(b2->get_executed_instructions() > 0);
+  std::cout << "Scheduler test CPU group share cap on idle cores passed.\n";
+  sched.stop();
+}
+
+static AffinityStats run_affinity(bool affinity)
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::RR;
+  cfg.quantum_cycles = 2;
+  cfg.affinity = affinity;
+  cfg.affinity_window = 1000;
+  cfg.cache_cold_penalty = 1;
+  Scheduler sched(cfg);
+
+  std::vector<Instruction> long_job(1000, {InstructionType::PRINT, {"A"}});
+  for (uint32_t i = 1; i <= 3; ++i)
+    sched.submit_process(std::make_shared<Process>(i, "a" + std::to_string(i), long_job));
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sched.pause();
+  AffinityStats s = sched.affinity_stats();
+  assert(!sched.affinity_report().empty());
+  sched.stop();
+  return s;
+}
+
+void test_affinity()
+{
+  // Three jobs on two cores: without affinity every other dispatch moves a
+  // job to the other core; with affinity each job sticks to its first core
+  AffinityStats off = run_affinity(false);
+  AffinityStats on = run_affinity(true);
+  std::cout << "Migrations without affinity: " << off.migrations
+            << ", with affinity: " << on.migrations << "\n";
+  assert(off.migrations > 0);
+  assert(off.stall_ticks > 0);
+  assert(on.migrations == 0);
+  assert(on.warm > 0);
+
+  std::cout << "Scheduler test affinity passed.\n";
+}
+
+void test_affinity_wide()
+{
+  // With more than 256 core slots, a process that never ran must still
+  // count as fresh: no migration, no cold dispatch, no penalty
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.max_cpu = 300;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.affinity = true;
+  cfg.affinity_window = 1000;
+  cfg.cache_cold_penalty = 5;
+  Scheduler sched(cfg);
+
+  std::vector<Instruction> job(20, {InstructionType::PRINT, {"W"}});
+  for (uint32_t i = 1; i <= 2; ++i)
+    sched.submit_process(std::make_shared<Process>(i, "w" + std::to_string(i), job));
+  sched.start();
+  while (sched.finished_count() < 2) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  AffinityStats s = sched.affinity_stats();
+  sched.stop();
+  assert(s.migrations == 0 && s.cold == 0 && s.stall_ticks == 0);
+
+  std::cout << "Scheduler test affinity with 300 core slots passed.\n";
+}
+
+void test_thread_pinning()
+{
+  Config cfg;
+  cfg.num_cpu = 3;
+  cfg.pin_scheduler = 0;
+  std::vector<int> host = {0, 1, 2, 3, 4, 5, 6, 7};
+
+  cfg.pin_workers = "compact";
+  assert((plan_pinning(cfg, host).worker_cpus == std::vector<int>{1, 2, 3}));
+  cfg.pin_workers = "scatter";
+  assert((plan_pinning(cfg, host).worker_cpus == std::vector<int>{1, 3, 5}));
+  cfg.pin_workers = "list";
+  cfg.pin_worker_cpus = {6, 7};
+  assert((plan_pinning(cfg, host).worker_cpus == std::vector<int>{6, 7, -1}));
+  cfg.pin_workers = "compact";
+  assert((plan_pinning(cfg, {0, 1}).worker_cpus == std::vector<int>{0, 1, 0})); // oversubscribed
+
+  // Pin to whatever this host allows; the applied layout must be reported
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.pin_scheduler = host_cpus().front();
+  Scheduler sched(cfg);
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  std::cout << sched.pinning_report();
+  assert(sched.pinning().worker_cpus.size() == 2);
+  sched.stop();
+
+  std::cout << "Scheduler test thread pinning passed.\n";
+}
+
+void test_cpu_hotplug()
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.max_cpu = 4;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::RR;
+  cfg.quantum_cycles = 3;
+  Scheduler sched(cfg);
+  assert(sched.get_cpu_count() == 2 && sched.get_cpu_capacity() == 4);
+
+  std::vector<Instruction> long_job(2000, {InstructionType::PRINT, {"H"}});
+  std::vector<std::shared_ptr<Process>> procs;
+  for (uint32_t i = 1; i <= 6; ++i) {
+    procs.push_back(std::make_shared<Process>(i, "h" + std::to_string(i), long_job));
+    sched.submit_process(procs.back());
+  }
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+  assert(sched.request_cpu_online(2));
+  assert(sched.request_cpu_online(3));
+  assert(!sched.request_cpu_online(3)); // already pending
+  assert(!sched.request_cpu_online(4)); // no such slot
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  assert(sched.get_cpu_count() == 4 && sched.is_cpu_online(3));
+
+  assert(sched.request_cpu_offline(0));
+  assert(sched.request_cpu_offline(1));
+  assert(sched.request_cpu_offline(2));
+  assert(!sched.request_cpu_offline(3)); // last online core
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  assert(sched.get_cpu_count() == 1 && !sched.is_cpu_online(0));
+
+  // Still ticking on the remaining core, and cores can come back
+  uint32_t tick = sched.current_tick();
+  assert(sched.request_cpu_online(0));
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  assert(sched.current_tick() > tick);
+  assert(sched.get_cpu_count() == 2 && sched.is_cpu_online(0));
+  sched.pause();
+
+  uint32_t running = 0;
+  for (auto &p : procs) running += p->state() == ProcessState::RUNNING;
+  assert(running == 2);
+  assert(sched.snapshot().find("OFFLINE") != std::string::npos);
+
+  std::cout << "Scheduler test CPU hotplug passed.\n";
+  sched.stop();
+}
+
+void test_cpu_hotplug_same_tick()
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  Scheduler sched(cfg);
+
+  // Queued before start, so both land in the first tick's batch
+  assert(sched.request_cpu_offline(1));
+  assert(sched.request_cpu_online(1));
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  assert(sched.current_tick() > 5);
+  assert(sched.get_cpu_count() == 2 && sched.is_cpu_online(1));
+
+  // Requests made while paused apply together; the last one wins
+  sched.pause();
+  assert(sched.request_cpu_offline(0));
+  assert(sched.request_cpu_online(0));
+  assert(sched.request_cpu_offline(0));
+  uint32_t tick = sched.current_tick();
+  sched.resume();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  assert(sched.current_tick() > tick);
+  assert(sched.get_cpu_count() == 1 && !sched.is_cpu_online(0));
+
+  std::cout << "Scheduler test CPU hotplug offline/online in one tick passed.\n";
+  sched.stop();
+}
+
+void test_reload_config()
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::RR;
+  Scheduler sched(cfg);
+  sched.start();
+
+  Config next = cfg;
+  next.delay_per_exec = 3;
+  next.quantum_cycles = 7;
+  next.num_cpu = 8;
+  auto keys = changed_keys(cfg, next);
+  assert(keys.size() == 3);
+  assert(is_live_key("delay-per-exec") && is_live_key("quantum-cycles") && !is_live_key("num-cpu"));
+
+  sched.reload_config(next);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  assert(sched.get_delay_per_exec() == 3);
+  assert(sched.get_cpu_count() == 2); // needs a restart
+  assert(sched.uses_quantum_cycles());
+  sched.stop();
+
+  // MLFQ quanta derived from quantum-cycles follow a reload; explicit ones
+  // do not, and CFS never reads quantum-cycles
+  cfg.scheduler = SchedulingPolicy::MLFQ;
+  cfg.quantum_cycles = 2;
+  Scheduler mlfq(cfg);
+  assert(mlfq.uses_quantum_cycles());
+  mlfq.start();
+  next = cfg;
+  next.quantum_cycles = 7;
+  next.affinity = true;
+  next.affinity_window = 9;
+  mlfq.reload_config(next);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  std::string snap = mlfq.snapshot(); // reads the reloaded keys off the scheduler thread
+  assert(snap.find("L0 (q=7)") != std::string::npos && snap.find("L1 (q=14)") != std::string::npos);
+  assert(snap.find("(window 9, cold penalty 0)") != std::string::npos);
+  mlfq.stop();
+
+  cfg.mlfq_quanta = {3, 5};
+  Scheduler explicit_quanta(cfg);
+  assert(!explicit_quanta.uses_quantum_cycles());
+  explicit_quanta.start();
+  explicit_quanta.reload_config(next);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  snap = explicit_quanta.snapshot();
+  assert(snap.find("L0 (q=3)") != std::string::npos && snap.find("L1 (q=5)") != std::string::npos);
+  explicit_quanta.stop();
+
+  cfg.scheduler = SchedulingPolicy::CFS;
+  assert(!Scheduler(cfg).uses_quantum_cycles());
+
+  std::cout << "Scheduler test reload config passed.\n";
+}
+
+void test_dispatch_latency()
+{
+  LogLinearHistogram h;
+  for (uint64_t v = 1; v <= 1000; ++v) h.record(v);
+  assert(h.count() == 1000 && h.max() == 1000);
+  assert(h.percentile(0.0) == 1 && h.percentile(1.0) == 1000);
+  uint64_t p50 = h.percentile(0.5);
+  assert(p50 >= 500 && p50 <= 500 + 500 / 16);  // within one sub-bucket
+  LogLinearHistogram before = h;
+  h.record(7, 10);
+  h.subtract(before);
+  assert(h.count() == 10 && h.percentile(0.99) == 7);
+
+  // Four processes on one core: each waits for the ones ahead of it
+  Config cfg;
+  cfg.num_cpu = 1;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.scheduler = SchedulingPolicy::FCFS;
+  Scheduler sched(cfg);
+  std::vector<Instruction> job(5, Instruction{InstructionType::DECLARE, {"x", "1"}});
+  for (uint32_t i = 1; i <= 4; ++i) sched.submit_process(std::make_shared<Process>(i, "l" + std::to_string(i), job));
+  sched.start();
+  while (sched.finished_count() < 4) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  TickStats stats = sched.tick_stats();
+  sched.stop();
+
+  LogLinearHistogram latency = sched.dispatch_latency();
+  assert(latency.count() == 4);
+  assert(latency.percentile(0.0) == 0 && latency.max() >= 15);
+  assert(stats.ticks > 20 && stats.wall_seconds > 0 && stats.participants == 1);
+  assert(stats.scheduler_barrier_seconds > 0 && stats.worker_barrier_seconds > 0);
+
+  // Idle workers wait out each 20 ms tick delay in the barrier. Waits that
+  // straddle a snapshot only count their share, so over a 30 ms window the
+  // mean wait per online core stays within the window.
+  cfg.num_cpu = 2;
+  cfg.max_cpu = 4;
+  cfg.scheduler_tick_delay = 20;
+  Scheduler idle(cfg);
+  idle.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (int i = 0; i < 5; ++i) {
+    TickStats from = idle.tick_stats();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    TickStats to = idle.tick_stats();
+    double wall = to.wall_seconds - from.wall_seconds;
+    double worker_share = (to.worker_barrier_seconds - from.worker_barrier_seconds) / (wall * to.participants);
+    double sched_share = (to.scheduler_barrier_seconds - from.scheduler_barrier_seconds) / wall;
+    assert(worker_share > 0.5 && worker_share <= 1.0 + 1e-6);
+    assert(sched_share >= 0 && sched_share <= 1.0 + 1e-6);
+  }
+  idle.stop();
+
+  std::cout << "Scheduler test dispatch latency passed.\n";
+}
+
+void test_utilization()
+{
+  // One long process on two cores; its name used to confuse the old
+  // IDLE-counting report
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1;
+  cfg.delay_per_exec = 100000;
+  Scheduler sched(cfg);
+  std::vector<Instruction> job(2, Instruction{InstructionType::DECLARE, {"x", "1"}});
+  sched.submit_process(std::make_shared<Process>(1, "IDLE", job));
+  sched.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  UtilizationReport u = sched.utilization();
+  TickStats stats = sched.tick_stats();
+  sched.stop();
+
+  assert(u.online == 2 && u.busy_now == 1 && u.cores.size() == 2);
+  uint64_t busy = u.cores[0].busy_ticks + u.cores[1].busy_ticks;
+  uint64_t idle = u.cores[0].idle_ticks + u.cores[1].idle_ticks;
+  assert(busy > 10 && busy + 2 >= idle && idle + 2 >= busy);
+  assert(stats.busy_core_ticks >= busy && stats.idle_core_ticks >= idle);
+  assert(u.windows.size() == 3 && u.windows[0].seconds == 1 && u.windows[2].seconds == 60);
+  for (const auto &w : u.windows) {
+    assert(w.busy_ticks > 0 && w.covered_seconds < 1.0);
+    assert(w.fraction() > 0.4 && w.fraction() < 0.6);
+  }
+
+  // ~300 snapshots were taken but only the newest few are kept; reading
+  // them drains the queue
+  std::string snaps = sched.get_sched_snapshots();
+  size_t kept = 0;
+  for (size_t at = snaps.find("=== Scheduler Snapshot"); at != std::string::npos;
+       at = snaps.find("=== Scheduler Snapshot", at + 1))
+    ++kept;
+  assert(kept == 8);
+  assert(sched.get_sched_snapshots().empty());
+
+  std::cout << "Scheduler test utilization passed.\n";
+}
+
+void test_latency()
+{
+  // Four equal processes on one core: FCFS never preempts, RR q=2 does
+  for (SchedulingPolicy policy : {SchedulingPolicy::FCFS, SchedulingPolicy::RR}) {
+    Config cfg;
+    cfg.num_cpu = 1;
+    cfg.scheduler_tick_delay = 1;
+    cfg.snapshot_cooldown = 1000;
+    cfg.scheduler = policy;
+    cfg.quantum_cycles = 2;
+    Scheduler sched(cfg);
+    assert(sched.latency_report().empty());
+    std::vector<Instruction> job(5, Instruction{InstructionType::DECLARE, {"x", "1"}});
+    std::vector<std::shared_ptr<Process>> procs;
+    for (uint32_t i = 1; i <= 4; ++i) {
+      procs.push_back(std::make_shared<Process>(i, "l" + std::to_string(i), job));
+      sched.submit_process(procs.back());
+    }
+    sched.start();
+    while (sched.finished_count() < 4) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    sched.stop();
+
+    std::vector<LatencySnapshot> rows = sched.latency();
+    assert(rows.size() == 1 && rows[0].label == policy_name(policy));
+    const LatencySnapshot &l = rows[0];
+    assert(l.response.count() == 4 && l.turnaround.count() == 4 && l.waiting.count() == 4);
+    assert(l.turnaround.percentile(0.0) >= 5 && l.turnaround.max() >= 20);
+    assert(l.turnaround.max() - l.waiting.max() >= 5); // the job itself takes 5 ticks
+    ProcessMetrics last = procs.back()->get_metrics();
+    assert(last.first_run_tick != UINT32_MAX && last.first_run_tick >= last.created_tick);
+    if (policy == SchedulingPolicy::FCFS) {
+      assert(l.preemptions.max() == 0 && l.response.max() == l.waiting.max());
+    } else {
+      assert(l.preemptions.max() >= 2 && l.response.max() < l.waiting.max());
+    }
+    assert(sched.latency_report().find("turnaround") != std::string::npos);
+  }
+
+  std::cout << "Scheduler test latency passed.\n";
+}
+
+void test_timeline()
+{
+  // A small ring keeps only the newest events
+  TimelineRing ring(4);
+  for (uint32_t i = 0; i < 10; ++i) ring.push({i, i, i, 0, TimelineKind::PHASE});
+  std::vector<TimelineEvent> kept = ring.snapshot();
+  assert(kept.size() >= 4 && kept.back().pid == 9 && ring.written() == 10);
+  for (size_t i = 1; i < kept.size(); ++i) assert(kept[i].tick == kept[i - 1].tick + 1);
+
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler = SchedulingPolicy::RR;
+  cfg.quantum_cycles = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  {
+    Scheduler off(cfg);
+    assert(off.timeline() == nullptr);
+  }
+
+  cfg.timeline_events = 4096;
+  Scheduler sched(cfg);
+  assert(sched.timeline() && sched.timeline()->cores() == 2);
+  std::vector<Instruction> job = {{InstructionType::DECLARE, {"x", "1"}},
+                                  {InstructionType::SLEEP, {"2"}},
+                                  {InstructionType::ADD, {"x", "x", "1"}},
+                                  {InstructionType::ADD, {"x", "x", "1"}},
+                                  {InstructionType::ADD, {"x", "x", "1"}}};
+  for (uint32_t i = 1; i <= 3; ++i) sched.submit_process(std::make_shared<Process>(i, "t" + std::to_string(i), job));
+  sched.start();
+  while (sched.finished_count() < 3) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  sched.stop();
+
+  std::vector<TimelineEvent> events = sched.timeline()->events();
+  auto count = [&](TimelineKind kind) {
+    return std::count_if(events.begin(), events.end(), [kind](const TimelineEvent &e) { return e.kind == kind; });
+  };
+  assert(count(TimelineKind::DISPATCH) >= 6 && count(TimelineKind::FINISH) == 3);
+  // A process may yield again while its sleep counter runs down
+  assert(count(TimelineKind::SLEEP) >= 3 && count(TimelineKind::WAKE) == count(TimelineKind::SLEEP));
+  assert(count(TimelineKind::YIELD) >= 6 && count(TimelineKind::PREEMPT) >= 1);
+  for (size_t i = 1; i < events.size(); ++i) assert(events[i].ns >= events[i - 1].ns);
+
+  uint64_t trace_events = 0;
+  std::string json = chrome_trace_json(*sched.timeline(), &trace_events);
+  assert(trace_events > 0 && json.front() == '{');
+  assert(json.find("\"name\":\"CPU 1\"") != std::string::npos);
+  assert(json.find("\"end\":\"sleep\"") != std::string::npos);
+  assert(json.find("\"name\":\"execute\"") != std::string::npos);
+
+  const std::string path = "/tmp/csopesy_test_timeline.json";
+  assert(write_chrome_trace(*sched.timeline(), path) == static_cast<int64_t>(trace_events));
+  assert(write_chrome_trace(*sched.timeline(), "/nonexistent/timeline.json") == -1);
+  std::remove(path.c_str());
+  std::cout << "Scheduler test timeline passed.\n";
+}
+
+void test_tick_profile()
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.max_cpu = 3;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  Scheduler sched(cfg);
+  assert(sched.tick_profile_report().find("no ticks") != std::string::npos);
+  std::vector<Instruction> job(20, Instruction{InstructionType::DECLARE, {"x", "1"}});
+  sched.submit_process(std::make_shared<Process>(1, "prof", job));
+  sched.start();
+  while (sched.current_tick() < 30) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  sched.stop();
+
+  TickProfile p = sched.tick_profile();
+  assert(p.phases.size() == kTimelinePhases);
+  for (const auto &c : p.phases) assert(c.total_ns > 0 && c.recent.count() >= 29);
+  // The tick delay dominates, and the scheduler waits while workers execute
+  assert(p.phases[static_cast<size_t>(TimelinePhase::IDLE)].total_ns >
+         p.phases[static_cast<size_t>(TimelinePhase::DISPATCH)].total_ns);
+  assert(p.workers.size() == 2 && p.workers[1].cpu == 1); // core 2 never came online
+  for (const auto &w : p.workers) {
+    assert(w.recent.count() >= 28 && w.round_ns[0] > 0);
+    assert(w.recent.max() <= w.round_ns[0] + w.round_ns[1] + w.round_ns[2]);
+  }
+
+  std::string report = sched.tick_profile_report();
+  assert(report.find("execute") != std::string::npos && report.find("dispatch") != std::string::npos);
+  std::cout << "Scheduler test tick profile passed.\n";
+}
+
+// Tick profile of two cores each running 32 PRINTs of `message_bytes`.
+// PRINT copies its message into the log, so the payload sets a tick's cost
+// while the short program keeps memory to a few MB
+static TickProfile execute_profile(size_t message_bytes)
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 0;
+  cfg.snapshot_cooldown = 1000;
+  Scheduler sched(cfg);
+  std::vector<Instruction> job(32, Instruction{InstructionType::PRINT, {std::string(message_bytes, 'x')}});
+  sched.submit_process(std::make_shared<Process>(1, "exec-a", job));
+  sched.submit_process(std::make_shared<Process>(2, "exec-b", job));
+  sched.start();
+  while (sched.current_tick() < 40) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  sched.stop();
+  return sched.tick_profile();
+}
+
+static uint64_t phase_ns(const TickProfile &p, TimelinePhase phase)
+{
+  return p.phases[static_cast<size_t>(phase)].total_ns;
+}
+
+void test_tick_profile_execute()
+{
+  // EXECUTE spans both barriers around the workers' run, so the cost of
+  // heavier instructions lands there rather than in log or advance.
+  // ADVANCE still holds the third barrier, about one barrier's wait
+  TickProfile light = execute_profile(1);
+  TickProfile heavy = execute_profile(128 * 1024);
+  auto after = [](const TickProfile &p) {
+    return phase_ns(p, TimelinePhase::LOG) + phase_ns(p, TimelinePhase::ADVANCE);
+  };
+  assert(phase_ns(light, TimelinePhase::EXECUTE) > phase_ns(light, TimelinePhase::ADVANCE) / 2);
+  int64_t execute_growth = static_cast<int64_t>(phase_ns(heavy, TimelinePhase::EXECUTE)) -
+                           static_cast<int64_t>(phase_ns(light, TimelinePhase::EXECUTE));
+  int64_t after_growth = static_cast<int64_t>(after(heavy)) - static_cast<int64_t>(after(light));
+  assert(execute_growth > 0 && execute_growth > after_growth);
+  std::cout << "Scheduler test tick profile execute phase passed.\n";
+}
+
+void test_opcode_profile()
+{
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.opcode_sample = 2;
+  {
+    Scheduler off(cfg);
+    assert(off.opcode_profile(0) == nullptr && !off.opcode_stats().enabled);
+    assert(off.opcode_stats_report().find("off") != std::string::npos);
+  }
+
+  // 5 instructions as written, 8 once FOR(3) is unrolled
+  std::vector<Instruction> job = {
+      {InstructionType::DECLARE, {"x", "1"}, {}},
+      {InstructionType::FOR, {"3"}, {{InstructionType::ADD, {"x", "x", "1"}, {}},
+                                     {InstructionType::PRINT, {"loop"}, {}}}},
+      {InstructionType::SLEEP, {"2"}, {}}};
+  cfg.opcode_profile = true;
+  Scheduler sched(cfg);
+  sched.submit_process(std::make_shared<Process>(1, "ops-a", job));
+  sched.submit_process(std::make_shared<Process>(2, "ops-b", job));
+  sched.start();
+  while (sched.finished_count() < 2) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  sched.stop();
+
+  OpcodeStats s = sched.opcode_stats();
+  assert(s.enabled && s.opcodes.size() == OpcodeProfile::kOpcodes);
+  auto executed = [&](InstructionType t) { return s.opcodes[static_cast<size_t>(t)].executed; };
+  assert(executed(InstructionType::DECLARE) == 2 && executed(InstructionType::ADD) == 6);
+  assert(executed(InstructionType::PRINT) == 6 && executed(InstructionType::SLEEP) == 2);
+  assert(executed(InstructionType::SUBTRACT) == 0 && executed(InstructionType::FOR) == 0);
+  uint64_t sampled = 0, per_core = 0;
+  for (const auto &c : s.opcodes) sampled += c.sampled;
+  for (uint64_t n : s.per_core) per_core += n;
+  assert(per_core == 16 && sampled >= 7 && sampled <= 9); // every second instruction on each core
+  assert(s.programs == 2 && s.source_instructions == 10 && s.unrolled_instructions == 16);
+
+  std::string report = sched.opcode_stats_report();
+  assert(report.find("SUBTRACT") != std::string::npos && report.find("(x1.60)") != std::string::npos);
+  std::cout << "Scheduler test opcode profile passed.\n";
+}
+
+void test_lock_stats()
+{
+  // ProfiledMutex is always built; LOCK_STATS only decides what TrackedMutex is
+  ProfiledMutex a("test.site");
+  ProfiledMutex b("test.site");               // same site, same counters
+  assert(lock_site("test.site") == lock_site("test.site"));
+  { std::lock_guard<ProfiledMutex> lock(b); }
+
+  std::atomic<bool> held{false};
+  std::thread holder([&] {
+    std::lock_guard<ProfiledMutex> lock(a);
+    held = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  });
+  while (!held) std::this_thread::yield();
+  assert(!a.try_lock());
+  { std::lock_guard<ProfiledMutex> lock(a); } // blocks until the holder is done
+  holder.join();
+
+  auto find = [](const std::string &name) {
+    for (const auto &s : lock_stats()) if (s.name == name) return s;
+    return LockSiteStats{};
+  };
+  LockSiteStats s = find("test.site");
+  assert(s.acquisitions == 3 && s.contended == 1);
+  assert(s.wait_ns >= 5'000'000 && s.max_wait_ns <= s.wait_ns);
+  assert(s.max_hold_ns >= 15'000'000 && s.hold_ns >= s.max_hold_ns);
+  assert(lock_stats().front().wait_ns >= s.wait_ns);  // ranked by wait
+
+  reset_lock_stats();
+  assert(find("test.site").acquisitions == 0);
+  assert(!lock_stats_report().empty());
+  std::cout << "Scheduler test lock stats passed.\n";
+}
+
+void test_record_replay()
+{
+  const std::string path = "/tmp/csopesy_test_trace.bin";
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler = SchedulingPolicy::RR;
+  cfg.quantum_cycles = 3;
+  cfg.min_ins = 5;
+  cfg.max_ins = 15;
+  cfg.batch_process_freq = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  cfg.seed = 7;
+  {
+    Scheduler sched(cfg);
+    assert(sched.record_trace(path));
+    ProcessGenerator gen(cfg, sched);
+    sched.start();
+    gen.start();
+    while (sched.current_tick() < 40) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    gen.stop();
+    while (!sched.is_idle()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    sched.stop();
+  }
+
+  SchedTrace trace;
+  std::string error;
+  assert(read_sched_trace(path, trace, error));
+  assert(trace.header.seed == 7 && trace.header.num_cpu == 2);
+  assert(trace.arrivals.size() >= 19 && trace.arrivals[0].name == "p01");
+  assert(trace.events.size() > 3 * trace.arrivals.size()); // arrival, dispatch, finish at least
+
+  // Same decisions without the tick delay
+  Config base;
+  base.snapshot_cooldown = 1000;
+  ReplayResult ok = replay_sched_trace(path, base);
+  assert(ok.ok && ok.matched == trace.events.size());
+
+  // A cache-cold penalty is not in the trace header and delays finishes
+  base.cache_cold_penalty = 3;
+  ReplayResult diverged = replay_sched_trace(path, base);
+  assert(!diverged.ok && diverged.matched < trace.events.size() && !diverged.divergence.empty());
+
+  assert(!replay_sched_trace("/nonexistent/trace", base).error.empty());
+  std::remove(path.c_str());
+  std::cout << "Scheduler test record/replay passed.\n";
+}
+
+void test_workload_trace()
+{
+  std::vector<Instruction> program;
+  std::string error;
+  assert(parse_program("DECLARE(x, 5); FOR(2){ADD(x, x, 1); PRINT(\"x, up\")}; SLEEP(1)", program, error));
+  assert(program.size() == 3 && program[1].nested.size() == 2 && program[1].nested[1].args[0] == "x, up");
+  std::vector<Instruction> again;
+  assert(parse_program(format_program(program), again, error) && format_program(again) == format_program(program));
+  assert(!parse_program("FOR(2){PRINT", again, error) && !error.empty());
+  assert(!parse_program("JUMP(3)", again, error));
+
+  const std::string path = "/tmp/csopesy_test_workload.txt";
+  {
+    std::ofstream out(path);
+    out << "# tick name priority program\n"
+        << "program short DECLARE(x, 1); PRINT(hi)\n"
+        << "0 a 1 @short\n"
+        << "0 b 2 SLEEP(1); PRINT(b)\n"
+        << "5 c 3 @short\n"
+        << "4 late 0 PRINT(no)\n"        // out of order: skipped
+        << "9 d 4 @missing\n"            // unknown image: skipped
+        << "12 e 5 @short\n";
+  }
+
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler_tick_delay = 1;
+  cfg.snapshot_cooldown = 1000;
+  Scheduler sched(cfg);
+  std::vector<std::pair<uint32_t, std::string>> arrivals;
+  std::vector<uint32_t> pids;
+  std::mutex arrivals_mtx;
+  sched.set_trace_hook([&](TraceKind kind, uint32_t tick, const Process &p, uint32_t) {
+    std::lock_guard<std::mutex> lock(arrivals_mtx);
+    if (kind != TraceKind::ARRIVAL) return;
+    arrivals.emplace_back(tick, p.name() + ":" + std::to_string(p.priority));
+    pids.push_back(p.id());
+  });
+  WorkloadReplay replay(sched, cfg);
+  assert(!WorkloadReplay(sched, cfg).start("/nonexistent/trace", error));
+  assert(replay.start(path, error));
+  sched.start();
+  while (!replay.done()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  while (!sched.is_idle()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  replay.stop();
+
+  // A second replay in the same session must not reuse the first one's pids
+  WorkloadReplay second(sched, cfg);
+  assert(second.start(path, error));
+  while (!second.done()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  while (!sched.is_idle()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  second.stop();
+  sched.stop();
+  std::remove(path.c_str());
+  assert(pids.size() == 8 && sched.finished_count() == 8);
+  std::sort(pids.begin(), pids.end());
+  assert(std::adjacent_find(pids.begin(), pids.end()) == pids.end());
+  arrivals.resize(4);
+
+  WorkloadReplayStatus st = replay.status();
+  assert(st.submitted == 4 && st.bad_lines == 2 && st.bytes_read == st.file_size);
+  assert(st.first_error.find("line 6") == 0);
+  const uint32_t t0 = arrivals[0].first;
+  assert(arrivals[0].second == "a:1" && arrivals[1] == std::make_pair(t0, std::string("b:2")));
+  assert(arrivals[2] == std::make_pair(t0 + 5, std::string("c:3")));
+  assert(arrivals[3] == std::make_pair(t0 + 12, std::string("e:5")));
+  std::cout << "Scheduler test workload trace replay passed.\n";
+}
+
+void test_sweep()
+{
+  SweepOptions opts;
+  opts.base.min_ins = 5;
+  opts.base.max_ins = 20;
+  opts.base.batch_process_freq = 2;
+  opts.base.seed = 11;
+  opts.processes = 40;
+  opts.jobs = 2;
+  std::string error;
+  SweepAxis cpus, policy, bad;
+  assert(parse_sweep_axis("num-cpu=1,2", cpus, error));
+  assert(parse_sweep_axis("scheduler=rr,fcfs", policy, error));
+  assert(!parse_sweep_axis("no-such-key=1", bad, error) && !error.empty());
+  assert(!parse_sweep_axis("num-cpu=two", bad, error));
+  opts.grid = {cpus, policy};
+
+  std::vector<SweepPoint> points;
+  assert(run_sweep(opts, points, error));
+  assert(points.size() == 4);
+  assert(points[0].values == (std::vector<std::string>{"1", "rr"}));
+  assert(points[3].values == (std::vector<std::string>{"2", "fcfs"}));
+  for (const auto &p : points) {
+    assert(p.completed && p.finished == 40);
+    assert(p.utilization > 0 && p.utilization <= 1.0);
+    assert(p.mean_turnaround >= p.mean_waiting);
+  }
+  assert(points[2].ticks <= points[0].ticks); // two cores never take longer
+
+  // Same seeded workload, same config: same result whichever instance ran it
+  std::vector<WorkloadRecord> workload;
+  assert(sweep_workload(opts, workload, error) && workload.size() == 40);
+  Config one = opts.base;
+  one.num_cpu = 2;
+  one.scheduler = SchedulingPolicy::FCFS;
+  SweepPoint again = run_sweep_point(one, workload, opts.max_ticks);
+  assert(again.ticks == points[3].ticks && again.mean_turnaround == points[3].mean_turnaround);
+  assert(sweep_csv(opts, points).rfind("num-cpu,scheduler,ticks", 0) == 0);
+  std::cout << "Scheduler test sweep passed.\n";
+}
+
+void test_shadow()
+{
+  // FCFS, one core: 4 then 2 ticks of work arriving together
+  ShadowModel fcfs(SchedulingPolicy::FCFS, 1, 1);
+  fcfs.arrive(0, 1, 4, 0);
+  fcfs.arrive(0, 2, 2, 0);
+  fcfs.advance_to(100);
+  assert(fcfs.turnaround().count() == 2 && fcfs.turnaround().max() == 6);
+  assert(fcfs.waiting().mean() == 2.0 && fcfs.in_flight() == 0);
+
+  // RR q=1 interleaves: the short job finishes at 4, the long one at 6
+  ShadowModel rr(SchedulingPolicy::RR, 1, 1);
+  rr.arrive(0, 1, 4, 0);
+  rr.arrive(0, 2, 2, 0);
+  rr.advance_to(100);
+  assert(rr.turnaround().mean() == 5.0 && rr.waiting().mean() == 2.0);
+
+  // PRIORITY preempts on arrival
+  ShadowModel prio(SchedulingPolicy::PRIORITY, 1, 1);
+  prio.arrive(0, 1, 10, 1);
+  prio.arrive(2, 2, 3, 5);
+  prio.advance_to(3);
+  assert(prio.turnaround().count() == 0);
+  prio.advance_to(5);
+  assert(prio.turnaround().count() == 1 && prio.turnaround().max() == 3);
+  prio.advance_to(100);
+  assert(prio.turnaround().max() == 13);
+
+  // Beside a live FCFS run, an FCFS shadow sees every process finish
+  Config cfg;
+  cfg.num_cpu = 2;
+  cfg.scheduler = SchedulingPolicy::FCFS;
+  cfg.scheduler_tick_delay = 0;
+  cfg.snapshot_cooldown = 50;
+  Scheduler sched(cfg);
+  ShadowScheduler shadow(sched, cfg, SchedulingPolicy::FCFS, 1);
+  shadow.start();
+  sched.start();
+  for (uint32_t i = 0; i < 20; ++i)
+    sched.submit_process(std::make_shared<Process>(i + 1, "s" + std::to_string(i),
+        std::vector<Instruction>(5, Instruction{InstructionType::DECLARE, {"x", "1"}, {}})));
+  while (!sched.is_idle()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  std::string report = shadow.report();
+  shadow.stop();
+  sched.stop();
+  assert(report.find("Shadow FCFS on 2 cores vs live FCFS") == 0);
+  std::istringstream lines(report);
+  std::string line, label;
+  uint64_t live_finished = 0, shadow_finished = 0;
+  while (std::getline(lines, line)) {
+    std::istringstream row(line);
+    row >> label;
+    if (label == "live") row >> live_finished;
+    if (label == "shadow" && line.find("vs") == std::string::npos) row >> shadow_finished;
+  }
+  assert(live_finished == 20 && shadow_finished == 20);
+  std::cout << "Scheduler test shadow scheduler passed.\n";
+}
+
+// Value of `"key":` in a flat JSON summary, up to the next ',' or '}'
+static std::string summary_field(const std::string &json, const std::string &key)
+{
+  size_t at = json.find("\"" + key + "\":");
+  assert(at != std::string::npos);
+  at += key.size() + 3;
+  std::string value = json.substr(at, json.find_first_of(",}", at) - at);
+  if (!value.empty() && value.front() == '"') value = value.substr(1, value.size() - 2);
+  return value;
+}
+
+static std::string run_batch_summary(BatchOptions opts)
+{
+  opts.summary_path = "/tmp/csopesy_test_batch.json";
+  int code = CLI().run_batch(opts);
+  assert(code == 0);
+  std::ifstream in(opts.summary_path);
+  std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  std::remove(opts.summary_path.c_str());
+  return json;
+}
+
+void test_batch_mode()
+{
+  BatchOptions opts;
+  opts.config_path = "/tmp/csopesy_test_batch_config.txt";
+  opts.script_path = "/tmp/csopesy_test_batch_script.txt";
+  opts.timeout_s = 60;
+  {
+    std::ofstream cfg(opts.config_path);
+    cfg << "num-cpu 2\nscheduler rr\nscheduler-tick-delay 0\nbatch-process-freq 1\n"
+        << "min-ins 2\nmax-ins 4\nsnapshot-cooldown 1000\n";
+    std::ofstream script(opts.script_path);
+    script << "# nightly smoke run\ninitialize\nscheduler-start\n";
+  }
+
+  // The summary is a contract for cron jobs: one timing per command (not
+  // per comment), the stop reason, and ticks measured after the script
+  opts.run_ticks = 50;
+  std::string json = run_batch_summary(opts);
+  assert(summary_field(json, "stop_reason") == "run-ticks");
+  assert(std::stoul(summary_field(json, "ticks")) >= opts.run_ticks);
+  assert(std::stod(summary_field(json, "ticks_per_sec")) > 0);
+  size_t commands = 0;
+  for (size_t at = json.find("{\"cmd\":"); at != std::string::npos; at = json.find("{\"cmd\":", at + 1)) ++commands;
+  assert(commands == 2);
+  assert(json.find("\"cmd\":\"initialize\"") < json.find("\"cmd\":\"scheduler-start\""));
+
+  // Let a few jobs arrive, then drain them
+  opts.run_ticks = 20;
+  opts.until_idle = true;
+  json = run_batch_summary(opts);
+  assert(summary_field(json, "stop_reason") == "until-idle");
+  assert(std::stoul(summary_field(json, "finished")) > 0);
+  assert(json.find("\"ms\":") != std::string::npos);
+
+  std::remove(opts.config_path.c_str());
+  std::remove(opts.script_path.c_str());
+  std::cout << "Scheduler test batch mode passed.\n";
+}
+
 int main()
 {
   // --- Test pause/resume ---
@@ -245,5 +1384,35 @@ int main()
 
   test_sleep();
   std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  test_priority_aging();
+  test_priority_preemption();
+  test_mlfq();
+  test_cfs();
+  test_edf();
+  test_priority_preemption(2);
+  test_mlfq(2);
+  test_edf(2);
+  test_cpu_groups();
+  test_group_share_cap_idle();
+  test_affinity();
+  test_affinity_wide();
+  test_thread_pinning();
+  test_cpu_hotplug();
+  test_cpu_hotplug_same_tick();
+  test_reload_config();
+  test_dispatch_latency();
+  test_utilization();
+  test_latency();
+  test_timeline();
+  test_tick_profile();
+  test_tick_profile_execute();
+  test_opcode_profile();
+  test_lock_stats();
+  test_record_replay();
+  test_workload_trace();
+  test_sweep();
+  test_shadow();
+  test_batch_mode();
   return 0;
 }